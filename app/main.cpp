@@ -1,33 +1,318 @@
 #include <config.h>
-#include <lexer.h>
+#include <module.h>
 #include <parse.h>
+#include <profiler.h>
 #include <runtime.h>
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
+// Параметры запуска интерпретатора
+struct Options {
+    // Включает автоматическую сборку циклических ссылок
+    bool gc = false;
+    // Выводит в cerr статистику сборщика мусора после завершения программы
+    bool gc_stats = false;
+    // Выводит в cerr статистику кэшей чистых методов после завершения программы
+    bool pure_stats = false;
+    // Файл, в который записывается профиль программы в формате свёрнутых стеков
+    string profile_path;
+    // Выводит в cerr счётчики исполнения программы в формате JSON
+    bool stats = false;
+    // Ограничения исполнения; срок задаётся относительно запуска программы
+    runtime::ExecutionLimits limits;
+    optional<chrono::milliseconds> timeout;
+    // Выводит в cerr наибольший объём памяти, занятой программой
+    bool memory_stats = false;
+    // Каталоги, в которых ищутся модули команды import. Пустой список - текущий каталог
+    vector<filesystem::path> module_path;
+    // Файл программы, которая исполняется заново после каждого изменения файла
+    filesystem::path watch_path;
+};
+
+// Период проверки файла программы в режиме --watch
+constexpr chrono::milliseconds WATCH_INTERVAL{200};
+
 void PrintInfo() {
     cout << PROJECT_NAME << " version: "sv << PROJECT_VER << endl;
 }
 
-void RunMythonProgram(istream &input, ostream &output) {
-    parse::Lexer lexer(input);
-    auto program = ParseProgram(lexer);
+void PrintUsage() {
+    cerr << "Usage: "sv << PROJECT_NAME << " [--gc] [--gc-stats] [--pure-stats] [--profile=<file>] [--stats]"
+            " [--max-steps=N] [--timeout=<ms>] [--max-depth=N]"
+            " [--max-memory=<bytes>] [--memory-stats] [--module-path=<dir>]..."
+            " (< script.my | --watch=<script.my>)"sv << endl;
+}
+
+// Возвращает значение параметра вида name=<число> или пустое значение, если arg - другой параметр
+optional<uint64_t> ParseNumberOption(string_view arg, string_view name) {
+    if (arg.substr(0, name.size()) != name || arg.size() == name.size()) {
+        return nullopt;
+    }
+    const string_view value = arg.substr(name.size());
+    uint64_t number = 0;
+    const auto [end, error] = from_chars(value.data(), value.data() + value.size(), number);
+    if (error != errc() || end != value.data() + value.size()) {
+        throw invalid_argument("Invalid value of option "s + string(arg));
+    }
+    return number;
+}
+
+Options ParseOptions(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if (arg == "--gc"sv) {
+            options.gc = true;
+        } else if (arg == "--gc-stats"sv) {
+            options.gc_stats = true;
+        } else if (arg == "--pure-stats"sv) {
+            options.pure_stats = true;
+        } else if (arg.substr(0, "--profile="sv.size()) == "--profile="sv &&
+                   arg.size() > "--profile="sv.size()) {
+            options.profile_path = string(arg.substr("--profile="sv.size()));
+        } else if (arg == "--stats"sv) {
+            if (!runtime::ExecutionStats::ENABLED) {
+                throw invalid_argument("Option --stats requires a build with MYTHON_STATS"s);
+            }
+            options.stats = true;
+        } else if (const auto steps = ParseNumberOption(arg, "--max-steps="sv)) {
+            options.limits.max_steps = *steps;
+        } else if (const auto timeout = ParseNumberOption(arg, "--timeout="sv)) {
+            options.timeout = chrono::milliseconds(*timeout);
+        } else if (const auto depth = ParseNumberOption(arg, "--max-depth="sv)) {
+            options.limits.max_call_depth = *depth;
+        } else if (const auto memory = ParseNumberOption(arg, "--max-memory="sv)) {
+            options.limits.max_memory = *memory;
+        } else if (arg == "--memory-stats"sv) {
+            options.memory_stats = true;
+        } else if (arg.substr(0, "--module-path="sv.size()) == "--module-path="sv &&
+                   arg.size() > "--module-path="sv.size()) {
+            options.module_path.emplace_back(arg.substr("--module-path="sv.size()));
+        } else if (arg.substr(0, "--watch="sv.size()) == "--watch="sv &&
+                   arg.size() > "--watch="sv.size()) {
+            options.watch_path = arg.substr("--watch="sv.size());
+        } else {
+            throw invalid_argument("Unknown option "s + string(arg));
+        }
+    }
+    return options;
+}
+
+void PrintGcStats(ostream &output) {
+    const auto &stats = runtime::GarbageCollector::Instance().GetStats();
+    output << "gc: collections="sv << stats.collections << " freed="sv << stats.freed
+           << " tracked="sv << stats.tracked << " total_pause_us="sv
+           << stats.total_pause.count() / 1000 << " max_pause_us="sv
+           << stats.max_pause.count() / 1000 << endl;
+}
+
+// Выводит статистику кэша каждого чистого метода классов, объявленных в программе
+void PrintPureStats(const runtime::Closure &globals, ostream &output) {
+    vector<const runtime::Class *> classes;
+    for (const auto &[name, value] : globals) {
+        if (const auto *cls = value.TryAs<runtime::Class>()) {
+            classes.push_back(cls);
+        }
+    }
+    sort(classes.begin(), classes.end(), [](const runtime::Class *lhs, const runtime::Class *rhs) {
+        return lhs->GetName() < rhs->GetName();
+    });
+
+    for (const auto *cls : classes) {
+        for (const auto &method : cls->GetMethods()) {
+            if (!method.cache) {
+                continue;
+            }
+            const auto &stats = method.cache->GetStats();
+            output << "pure: "sv << cls->GetName() << '.' << method.name << " hits="sv
+                   << stats.hits << " misses="sv << stats.misses << " evictions="sv
+                   << stats.evictions << " uncacheable="sv << stats.uncacheable << " size="sv
+                   << method.cache->Size() << endl;
+        }
+    }
+}
+
+// Выводит счётчики исполнения одним объектом JSON
+void PrintStats(const runtime::ExecutionStats &stats, ostream &output) {
+    using runtime::ExecutionStats;
+
+    output << "{\"nodes\": {"sv;
+    for (size_t i = 0; i < stats.nodes.size(); ++i) {
+        output << (i == 0 ? ""sv : ", "sv) << '"'
+               << ExecutionStats::GetName(static_cast<ExecutionStats::NodeType>(i))
+               << "\": "sv << stats.nodes[i];
+    }
+    output << "}, \"method_calls\": "sv << stats.method_calls << ", \"allocations\": {"sv;
+    for (size_t i = 0; i < stats.allocations.size(); ++i) {
+        output << (i == 0 ? ""sv : ", "sv) << '"'
+               << ExecutionStats::GetName(static_cast<ExecutionStats::ObjectType>(i))
+               << "\": "sv << stats.allocations[i];
+    }
+    output << "}, \"closure_insertions\": "sv << stats.closure_insertions
+           << ", \"exceptions\": "sv << stats.exceptions << '}' << endl;
+}
+
+void PrintMemoryStats(const runtime::Context &context, ostream &output) {
+    output << "memory: peak_bytes="sv << context.GetPeakMemoryUsage() << " current_bytes="sv
+           << context.GetMemoryUsage() << endl;
+}
+
+void ExecuteProgram(runtime::Executable &program,
+                    runtime::Closure &closure,
+                    runtime::Context &context,
+                    const Options &options) {
+    if (options.profile_path.empty()) {
+        program.Execute(closure, context);
+        return;
+    }
+
+    // Файл открывается заранее, чтобы не узнать о недоступном пути после долгой работы
+    ofstream profile_output(options.profile_path);
+    if (!profile_output) {
+        throw runtime_error("Can't open profile output file "s + options.profile_path);
+    }
+    runtime::Profiler profiler(runtime::CallStack::Instance());
+    profiler.Start();
+    program.Execute(closure, context);
+    profiler.Stop();
+    profiler.WriteFolded(profile_output);
+}
+
+// Разбирает программу функцией parse и исполняет её с пустыми глобальными переменными.
+// Программа разбирается в контексте исполнения, поэтому модули, которые она импортирует,
+// исполняются с её ограничениями
+void RunProgram(const function<unique_ptr<runtime::Executable>()> &parse,
+                ostream &output,
+                const Options &options) {
+    auto limits = options.limits;
+    if (options.timeout) {
+        limits.deadline = chrono::steady_clock::now() + *options.timeout;
+    }
 
     runtime::SimpleContext context{output};
+    context.SetLimits(limits);
+    const auto program = parse();
     runtime::Closure closure;
-    program->Execute(closure, context);
+    try {
+        ExecuteProgram(*program, closure, context, options);
+    } catch (const exception &) {
+        // Счётчики выводятся и для программы, завершившейся ошибкой
+        if (options.stats) {
+            PrintStats(context.GetStats(), cerr);
+        }
+        if (options.memory_stats) {
+            PrintMemoryStats(context, cerr);
+        }
+        throw;
+    }
+
+    if (options.stats) {
+        PrintStats(context.GetStats(), cerr);
+    }
+    if (options.memory_stats) {
+        PrintMemoryStats(context, cerr);
+    }
+    if (options.pure_stats) {
+        PrintPureStats(closure, cerr);
+    }
+}
+
+void RunMythonProgram(istream &input, ostream &output, const Options &options) {
+    const string source{istreambuf_iterator<char>(input), istreambuf_iterator<char>()};
+    RunProgram(
+        [&] {
+            return ParseProgram(source);
+        },
+        output, options);
+}
+
+// Исполняет программу из файла path и исполняет её заново после каждого изменения файла, пока
+// процесс не будет остановлен. Ошибки разбора и исполнения выводятся в cerr и не прекращают
+// наблюдение. Изменённая программа разбирается заново лишь в изменённых частях
+// (см. IncrementalParser), время разбора и количество частей выводятся в cerr
+[[noreturn]] void WatchMythonProgram(const filesystem::path &path, ostream &output,
+                                     const Options &options) {
+    // Время изменения и размер файла, который исполнялся последним
+    optional<pair<filesystem::file_time_type, uintmax_t>> last_stamp;
+    IncrementalParser parser;
+    for (;; this_thread::sleep_for(WATCH_INTERVAL)) {
+        error_code mtime_error;
+        error_code size_error;
+        const auto stamp = make_pair(filesystem::last_write_time(path, mtime_error),
+                                     filesystem::file_size(path, size_error));
+        // Файла может не быть, пока редактор сохраняет его
+        if (mtime_error || size_error || stamp == last_stamp) {
+            continue;
+        }
+        last_stamp = stamp;
+
+        try {
+            ifstream input(path, ios::binary);
+            const string source{istreambuf_iterator<char>(input), istreambuf_iterator<char>()};
+            const auto parse = [&] {
+                const auto start = chrono::steady_clock::now();
+                auto program = parser.Parse(source);
+                const auto parse_time = chrono::steady_clock::now() - start;
+                const auto &stats = parser.GetStats();
+                cerr << "watch: parsed="sv << stats.parsed << " reused="sv << stats.reused
+                     << " parse_us="sv
+                     << chrono::duration_cast<chrono::microseconds>(parse_time).count() << endl;
+                return program;
+            };
+            RunProgram(parse, output, options);
+        } catch (const exception &e) {
+            cerr << e.what() << endl;
+        }
+        output.flush();
+    }
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+    Options options;
+    try {
+        options = ParseOptions(argc, argv);
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        PrintUsage();
+        return 1;
+    }
+
     PrintInfo();
+    runtime::GarbageCollector::Instance().SetEnabled(options.gc);
+    if (!options.module_path.empty()) {
+        runtime::ModuleCache::Instance().SetSearchPath(options.module_path);
+    }
+    if (!options.watch_path.empty()) {
+        if (!filesystem::exists(options.watch_path)) {
+            cerr << "Can't open program file "sv << options.watch_path.string() << endl;
+            return 1;
+        }
+        WatchMythonProgram(options.watch_path, cout, options);
+    }
     try {
-        RunMythonProgram(cin, cout);
+        RunMythonProgram(cin, cout, options);
     } catch (const exception &e) {
         cerr << e.what() << endl;
         return 1;
     }
 
+    if (options.gc_stats) {
+        PrintGcStats(cerr);
+    }
     return 0;
-}
\ No newline at end of file
+}
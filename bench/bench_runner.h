@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Параметры запуска бенчмарков
+struct BenchOptions {
+    // Сколько раз выполняется каждый бенчмарк
+    int repetitions = 1;
+    // Выполняются только бенчмарки, в имени которых есть эта подстрока
+    std::string filter;
+    // Файл для результатов в формате JSON; "-" - стандартный вывод
+    std::string json_path;
+};
+
+// Разбирает параметры --repetitions=N, --filter=substring и --json=file
+inline BenchOptions ParseBenchOptions(int argc, char *argv[]) {
+    using namespace std::literals;
+
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto value_of = [arg](std::string_view name) {
+            return arg.substr(0, name.size()) == name ? arg.substr(name.size()) : ""sv;
+        };
+        if (const auto value = value_of("--repetitions="sv); !value.empty()) {
+            options.repetitions = std::stoi(std::string(value));
+            if (options.repetitions < 1) {
+                throw std::invalid_argument("Repetitions must be positive"s);
+            }
+        } else if (const auto value = value_of("--filter="sv); !value.empty()) {
+            options.filter = std::string(value);
+        } else if (const auto value = value_of("--json="sv); !value.empty()) {
+            options.json_path = std::string(value);
+        } else {
+            throw std::invalid_argument("Unknown option "s + std::string(arg));
+        }
+    }
+    return options;
+}
+
+// Сводка времени повторных запусков бенчмарка, в миллисекундах
+struct BenchSummary {
+    std::string name;
+    size_t runs = 0;
+    double min = 0;
+    double median = 0;
+    double mean = 0;
+    double max = 0;
+    // Выборочное стандартное отклонение
+    double stddev = 0;
+};
+
+inline BenchSummary Summarize(std::string name, std::vector<double> times) {
+    std::sort(times.begin(), times.end());
+    BenchSummary summary;
+    summary.name = std::move(name);
+    summary.runs = times.size();
+    summary.min = times.front();
+    summary.max = times.back();
+    const size_t middle = times.size() / 2;
+    summary.median =
+        times.size() % 2 == 1 ? times[middle] : (times[middle - 1] + times[middle]) / 2;
+    summary.mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    if (times.size() > 1) {
+        double squares = 0;
+        for (const double time : times) {
+            squares += (time - summary.mean) * (time - summary.mean);
+        }
+        summary.stddev = std::sqrt(squares / (times.size() - 1));
+    }
+    return summary;
+}
+
+class BenchRunner {
+  public:
+    BenchRunner() = default;
+    explicit BenchRunner(BenchOptions options) : options_(std::move(options)) {}
+
+    template <class BenchFunc>
+    void RunBench(BenchFunc func, const std::string &bench_name) {
+        if (bench_name.find(options_.filter) == std::string::npos) {
+            return;
+        }
+        std::vector<double> times;
+        for (int i = 0; i < options_.repetitions; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            try {
+                func();
+            } catch (std::exception &e) {
+                ++fail_count;
+                std::cerr << bench_name << " fail: " << e.what() << std::endl;
+                return;
+            } catch (...) {
+                ++fail_count;
+                std::cerr << "Unknown exception caught" << std::endl;
+                return;
+            }
+            const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+            times.push_back(elapsed.count());
+        }
+
+        summaries_.push_back(Summarize(bench_name, std::move(times)));
+        const BenchSummary &summary = summaries_.back();
+        if (summary.runs == 1) {
+            std::cerr << bench_name << " " << std::llround(summary.median) << " ms" << std::endl;
+        } else {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << bench_name << " median "
+                 << summary.median << " ms (min " << summary.min << ", max " << summary.max
+                 << ", stddev " << summary.stddev << ", " << summary.runs << " runs)";
+            std::cerr << line.str() << std::endl;
+        }
+    }
+
+    ~BenchRunner() {
+        if (!options_.json_path.empty()) {
+            if (options_.json_path == "-") {
+                WriteJson(std::cout);
+            } else {
+                std::ofstream output(options_.json_path);
+                WriteJson(output);
+                if (!output) {
+                    std::cerr << "Can't write " << options_.json_path << std::endl;
+                    ++fail_count;
+                }
+            }
+        }
+        std::cerr.flush();
+        if (fail_count > 0) {
+            std::cerr << fail_count << " benchmarks failed. Terminate" << std::endl;
+            exit(1);
+        }
+    }
+
+  private:
+    // Выводит сводки в виде {"benchmarks": [{"name": ..., "runs": ..., "min_ms": ...}]}
+    void WriteJson(std::ostream &output) const {
+        output << "{\"repetitions\": " << options_.repetitions << ", \"benchmarks\": [";
+        bool first = true;
+        for (const auto &summary : summaries_) {
+            output << (first ? "\n  " : ",\n  ") << "{\"name\": \"" << summary.name
+                   << "\", \"runs\": " << summary.runs << ", \"min_ms\": " << summary.min
+                   << ", \"median_ms\": " << summary.median << ", \"mean_ms\": " << summary.mean
+                   << ", \"max_ms\": " << summary.max << ", \"stddev_ms\": " << summary.stddev
+                   << '}';
+            first = false;
+        }
+        output << "\n]}" << std::endl;
+    }
+
+    BenchOptions options_;
+    std::vector<BenchSummary> summaries_;
+    int fail_count = 0;
+};
+
+#define RUN_BENCH(br, func) br.RunBench(func, #func)
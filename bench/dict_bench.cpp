@@ -0,0 +1,78 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+
+#include <string>
+
+using namespace std;
+
+namespace {
+
+const int KEY_COUNT = 1000000;
+
+// Добавляет в словарь 1 000 000 ключей и ищет каждый из них из программы на Mython
+void BenchDictInsertLookup() {
+    ExpectOutput(R"(
+d = {}
+for i in range(0, 1000000):
+  d[i] = i
+found = 0
+for i in range(0, 1000000):
+  if d[i] == i:
+    found = found + 1
+print len(d), found
+)",
+                 "1000000 1000000\n");
+}
+
+// Вставка и поиск 1 000 000 числовых ключей в runtime::Dict
+void BenchDictNumberKeys() {
+    runtime::Dict dict;
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        dict.Set(runtime::ObjectHolder::Own(runtime::Number(i)),
+                 runtime::ObjectHolder::Own(runtime::Number(i)));
+    }
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        if (!dict.Find(runtime::ObjectHolder::Own(runtime::Number(i)))) {
+            throw runtime_error("Key not found");
+        }
+    }
+}
+
+// То же через поля экземпляра класса, которыми словари заменяли до их появления.
+// Поля именуются только идентификаторами, поэтому ключи - строки вида "k123"
+void BenchFieldsWorkaround() {
+    runtime::Class cls("Storage"s, {}, nullptr);
+    runtime::ClassInstance storage(cls);
+    auto &fields = storage.Fields();
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        fields["k"s + to_string(i)] = runtime::ObjectHolder::Own(runtime::Number(i));
+    }
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        if (fields.find("k"s + to_string(i)) == fields.end()) {
+            throw runtime_error("Field not found");
+        }
+    }
+}
+
+// Поиск строковых ключей в runtime::Dict для сравнения с полями
+void BenchDictStringKeys() {
+    runtime::Dict dict;
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        dict.Set(runtime::ObjectHolder::Own(runtime::String("k"s + to_string(i))),
+                 runtime::ObjectHolder::Own(runtime::Number(i)));
+    }
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        if (!dict.Find(runtime::ObjectHolder::Own(runtime::String("k"s + to_string(i))))) {
+            throw runtime_error("Key not found");
+        }
+    }
+}
+
+} // namespace
+
+void RunDictBenchmarks(BenchRunner &br) {
+    RUN_BENCH(br, BenchDictInsertLookup);
+    RUN_BENCH(br, BenchDictNumberKeys);
+    RUN_BENCH(br, BenchDictStringKeys);
+    RUN_BENCH(br, BenchFieldsWorkaround);
+}
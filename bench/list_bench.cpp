@@ -0,0 +1,50 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+
+using namespace std;
+
+namespace {
+
+// 10 раз заполняет список из 10 000 чисел и суммирует его элементы
+void BenchListAppendAndSum() {
+    ExpectOutput(R"(
+total = 0
+for round in range(0, 10):
+  items = []
+  for i in range(0, 10000):
+    items.append(i)
+  for item in items:
+    total = total + item
+print total
+)",
+                 "499950000\n");
+}
+
+// То же на связном списке из экземпляров классов, которым списки заменяли до их появления
+void BenchLinkedListAppendAndSum() {
+    ExpectOutput(R"(
+class Node:
+  def __init__(value, next):
+    self.value = value
+    self.next = next
+
+total = 0
+for round in range(0, 10):
+  head = None
+  for i in range(0, 10000):
+    head = Node(i, head)
+  node = head
+  for i in range(0, 10000):
+    total = total + node.value
+    node = node.next
+print total
+)",
+                 "499950000\n");
+}
+
+} // namespace
+
+void RunListBenchmarks(BenchRunner &br) {
+    RUN_BENCH(br, BenchListAppendAndSum);
+    RUN_BENCH(br, BenchLinkedListAppendAndSum);
+}
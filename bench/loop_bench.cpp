@@ -0,0 +1,67 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+
+using namespace std;
+
+namespace {
+
+// Счётчик до 10 000 000 на цикле while
+void BenchWhileCounter() {
+    ExpectOutput(R"(
+i = 0
+while i < 10000000:
+  i = i + 1
+print i
+)",
+                 "10000000\n");
+}
+
+// Тот же счётчик на цикле for по диапазону
+void BenchForRangeCounter() {
+    ExpectOutput(R"(
+total = 0
+for i in range(0, 10000000):
+  total = i
+print total
+)",
+                 "9999999\n");
+}
+
+// Тот же счётчик на хвостовой рекурсии
+void BenchRecursiveCounter() {
+    ExpectOutput(R"(
+class Counter:
+  def count(i, n):
+    if i < n:
+      return self.count(i + 1, n)
+    return i
+
+counter = Counter()
+print counter.count(0, 10000000)
+)",
+                 "10000000\n");
+}
+
+// Рекурсия глубиной 1 000 000 через хвостовые вызовы
+void BenchDeepTailRecursion() {
+    ExpectOutput(R"(
+class Counter:
+  def count(n, acc):
+    if n == 0:
+      return acc
+    return self.count(n - 1, acc + 1)
+
+counter = Counter()
+print counter.count(1000000, 0)
+)",
+                 "1000000\n");
+}
+
+} // namespace
+
+void RunLoopBenchmarks(BenchRunner &br) {
+    RUN_BENCH(br, BenchWhileCounter);
+    RUN_BENCH(br, BenchForRangeCounter);
+    RUN_BENCH(br, BenchRecursiveCounter);
+    RUN_BENCH(br, BenchDeepTailRecursion);
+}
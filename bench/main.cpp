@@ -0,0 +1,34 @@
+#include "bench_runner.h"
+
+#include <iostream>
+
+void RunLoopBenchmarks(BenchRunner &br);
+void RunListBenchmarks(BenchRunner &br);
+void RunDictBenchmarks(BenchRunner &br);
+void RunStringBenchmarks(BenchRunner &br);
+void RunNumberBenchmarks(BenchRunner &br);
+void RunParseBenchmarks(BenchRunner &br);
+void RunRuntimeBenchmarks(BenchRunner &br);
+void RunScriptBenchmarks(BenchRunner &br);
+void RunWorkloadBenchmarks(BenchRunner &br);
+void RunSnapshotBenchmarks(BenchRunner &br);
+
+int main(int argc, char *argv[]) {
+    try {
+        BenchRunner br(ParseBenchOptions(argc, argv));
+        RunLoopBenchmarks(br);
+        RunListBenchmarks(br);
+        RunDictBenchmarks(br);
+        RunStringBenchmarks(br);
+        RunNumberBenchmarks(br);
+        RunParseBenchmarks(br);
+        RunRuntimeBenchmarks(br);
+        RunScriptBenchmarks(br);
+        RunWorkloadBenchmarks(br);
+        RunSnapshotBenchmarks(br);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
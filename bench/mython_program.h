@@ -0,0 +1,30 @@
+#pragma once
+
+#include "lexer.h"
+#include "parse.h"
+#include "runtime.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Исполняет программу на Mython и возвращает её вывод
+inline std::string RunMythonProgram(const std::string &program) {
+    std::istringstream input(program);
+    parse::Lexer lexer(input);
+    auto tree = ParseProgram(lexer);
+
+    std::ostringstream output;
+    runtime::SimpleContext context{output};
+    runtime::Closure closure;
+    tree->Execute(closure, context);
+    return output.str();
+}
+
+// Исполняет программу и проверяет, что она вывела expected
+inline void ExpectOutput(const std::string &program, const std::string &expected) {
+    const std::string output = RunMythonProgram(program);
+    if (output != expected) {
+        throw std::runtime_error("Unexpected output: " + output);
+    }
+}
@@ -0,0 +1,65 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+
+using namespace std;
+
+namespace {
+
+// Вычисляет 100 раз факториал 1000: произведение длинного числа на короткое
+void BenchFactorial1000() {
+    ExpectOutput(R"(
+class Factorial:
+  def calc(n):
+    result = 1
+    for i in range(2, n + 1):
+      result = result * i
+    return result
+
+f = Factorial()
+for i in range(0, 100):
+  x = f.calc(1000)
+print len(str(x)), x / f.calc(999)
+)",
+                 "2568 1000\n");
+}
+
+// Возводит 3 в степень 4096 последовательными возведениями в квадрат. Длинные множители
+// перемножаются алгоритмом Карацубы
+void BenchBigSquaring() {
+    ExpectOutput(R"(
+for i in range(0, 2000):
+  x = 3
+  for j in range(0, 12):
+    x = x * x
+print len(str(x))
+)",
+                 "1955\n");
+}
+
+// Числа Фибоначчи экспоненциальным рекурсивным методом, помеченным @pure: каждое значение
+// вычисляется один раз, остальные 100 000 вызовов берут результат из кэша
+void BenchPureFibonacci() {
+    ExpectOutput(R"(
+class Fibonacci:
+  @pure
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+fib = Fibonacci()
+total = 0
+for i in range(0, 100000):
+  total = total + fib.calc(i - i / 50 * 50)
+print fib.calc(90), total
+)",
+                 "2880067194370816120 40730022146000\n");
+}
+
+} // namespace
+
+void RunNumberBenchmarks(BenchRunner &br) {
+    RUN_BENCH(br, BenchFactorial1000);
+    RUN_BENCH(br, BenchBigSquaring);
+    RUN_BENCH(br, BenchPureFibonacci);
+}
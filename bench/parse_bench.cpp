@@ -0,0 +1,179 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+
+using namespace std;
+
+namespace {
+
+// Программа из нескольких тысяч классов: методы с условиями, циклами, вызовами, списками и
+// словарями. Около 40 000 строк
+string MakeLargeProgram() {
+    string program;
+    for (int i = 0; i < 2000; ++i) {
+        const string n = to_string(i);
+        program += "class Shape" + n + ":\n"
+                   "  def __init__(width, height):\n"
+                   "    self.width = width\n"
+                   "    self.height = height\n"
+                   "    self.tags = ['shape', 'n" + n + "']\n"
+                   "\n"
+                   "  def area():\n"
+                   "    return self.width * self.height\n"
+                   "\n"
+                   "  def describe(prefix):\n"
+                   "    if self.area() > " + n + " and not self.width == 0:\n"
+                   "      return prefix + ' big ' + str(self.area())\n"
+                   "    else:\n"
+                   "      return prefix + \" small\"\n"
+                   "\n"
+                   "shape = Shape" + n + "(" + n + ", 2)\n"
+                   "total = 0\n"
+                   "for i in range(0, 3):\n"
+                   "  total = total + shape.area() / (i + 1)\n";
+    }
+    return program + "print total\n";
+}
+
+// Библиотека из 20 000 классов без инструкций верхнего уровня: цепочки наследования по четыре
+// класса, методы которых создают объекты первого класса цепочки. Около 5 МБ
+string MakeLibrary() {
+    string program;
+    for (int i = 0; i < 20000; ++i) {
+        const string n = to_string(i);
+        const string root = "Node" + to_string(i - i % 4);
+        program += i % 4 == 0 ? "class Node" + n + ":\n"
+                              : "class Node" + n + "(Node" + to_string(i - 1) + "):\n";
+        program += "  def __init__(value):\n"
+                   "    self.value = value\n"
+                   "    self.children = []\n"
+                   "\n"
+                   "  def add(child):\n"
+                   "    self.children.append(child)\n"
+                   "    return len(self.children)\n"
+                   "\n"
+                   "  def total():\n"
+                   "    result = self.value\n"
+                   "    for child in self.children:\n"
+                   "      result = result + child.total()\n"
+                   "    return result\n"
+                   "\n"
+                   "  def spawn(n):\n"
+                   "    if n > " + n + ":\n"
+                   "      return " + (i % 4 == 0 ? "None"s : root + "(n)") + "\n"
+                   "    return self\n"
+                   "\n";
+    }
+    return program;
+}
+
+const string &Library() {
+    static const string program = MakeLibrary();
+    return program;
+}
+
+const string &LargeProgram() {
+    static const string program = MakeLargeProgram();
+    return program;
+}
+
+// Разбивает большую программу на лексемы
+void BenchLexerNextToken() {
+    istringstream input(LargeProgram());
+    parse::Lexer lexer(input);
+    size_t tokens = 1;
+    while (!lexer.CurrentToken().Is<parse::token_type::Eof>()) {
+        lexer.NextToken();
+        ++tokens;
+    }
+    if (tokens < 100000) {
+        throw runtime_error("Too few tokens: " + to_string(tokens));
+    }
+}
+
+// Строит синтаксическое дерево большой программы
+void BenchParseProgram() {
+    istringstream input(LargeProgram());
+    parse::Lexer lexer(input);
+    auto tree = ParseProgram(lexer);
+    if (!tree) {
+        throw runtime_error("Empty program");
+    }
+}
+
+// Разбирает библиотеку последовательно
+void BenchParseLibrary() {
+    istringstream input(Library());
+    parse::Lexer lexer(input);
+    if (!ParseProgram(lexer)) {
+        throw runtime_error("Empty program");
+    }
+}
+
+// Разбирает библиотеку, разбирая независимые классы параллельно по числу ядер
+void BenchParseLibraryParallel() {
+    if (!ParseProgram(Library())) {
+        throw runtime_error("Empty program");
+    }
+}
+
+// Библиотека с изменённой строкой метода класса из середины
+const string &EditedLibrary() {
+    static const string program = [] {
+        string result = Library();
+        const string line = "    if n > 10000:\n";
+        result.replace(result.find(line), line.size(), "    if n > 10001:\n");
+        return result;
+    }();
+    return program;
+}
+
+// Библиотека со вставленной первой строкой: все классы смещаются на строку вниз
+const string &ShiftedLibrary() {
+    static const string program = "version = 2\n"s + Library();
+    return program;
+}
+
+IncrementalParser &WarmIncrementalParser() {
+    static IncrementalParser parser;
+    static const bool warm = (parser.Parse(Library()), true);
+    (void)warm;
+    return parser;
+}
+
+// Разбирает библиотеку после правки одной строки, повторно используя неизменённые классы
+void BenchIncrementalReparse() {
+    static bool edited = false;
+    edited = !edited;
+    auto &parser = WarmIncrementalParser();
+    if (!parser.Parse(edited ? EditedLibrary() : Library()) || parser.GetStats().reused == 0) {
+        throw runtime_error("Library was not reused");
+    }
+}
+
+// Разбирает библиотеку после вставки или удаления первой строки
+void BenchIncrementalReparseShifted() {
+    static bool shifted = false;
+    shifted = !shifted;
+    auto &parser = WarmIncrementalParser();
+    if (!parser.Parse(shifted ? ShiftedLibrary() : Library()) || parser.GetStats().reused == 0) {
+        throw runtime_error("Library was not reused");
+    }
+}
+
+} // namespace
+
+void RunParseBenchmarks(BenchRunner &br) {
+    // Программы строятся до замеров
+    LargeProgram();
+    Library();
+    EditedLibrary();
+    ShiftedLibrary();
+    WarmIncrementalParser();
+
+    RUN_BENCH(br, BenchLexerNextToken);
+    RUN_BENCH(br, BenchParseProgram);
+    RUN_BENCH(br, BenchParseLibrary);
+    RUN_BENCH(br, BenchParseLibraryParallel);
+    RUN_BENCH(br, BenchIncrementalReparse);
+    RUN_BENCH(br, BenchIncrementalReparseShifted);
+}
@@ -0,0 +1,244 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+#include "statement.h"
+
+#include <streambuf>
+
+using namespace std;
+
+namespace {
+
+using runtime::ObjectHolder;
+
+constexpr int ITERATIONS = 1000000;
+
+// Поток вывода, отбрасывающий всё записанное в него
+class NullBuffer : public streambuf {
+  protected:
+    int_type overflow(int_type ch) override {
+        return ch;
+    }
+};
+
+// Объявляет классы программы program и хранит их вместе с синтаксическим деревом,
+// которому принадлежат тела методов
+class ProgramClasses {
+  public:
+    explicit ProgramClasses(const string &program) {
+        istringstream input(program);
+        parse::Lexer lexer(input);
+        tree_ = ParseProgram(lexer);
+        runtime::DummyContext context;
+        tree_->Execute(closure_, context);
+    }
+
+    [[nodiscard]] ObjectHolder NewInstance(const string &class_name) const {
+        return ObjectHolder::Own(
+            runtime::ClassInstance(*closure_.at(class_name).TryAs<runtime::Class>()));
+    }
+
+  private:
+    unique_ptr<ast::Statement> tree_;
+    runtime::Closure closure_;
+};
+
+const string CLASSES = R"(
+class Box:
+  def __init__(value):
+    self.value = value
+
+  def get(x):
+    return x
+
+  def __eq__(other):
+    return self.value == other.value
+
+  def __lt__(other):
+    return self.value < other.value
+
+  def __add__(other):
+    return self.value + other.value
+
+box = Box(0)
+)";
+
+ObjectHolder MakeBigNumber() {
+    runtime::BigInt value = 1;
+    for (int i = 0; i < 5; ++i) {
+        value = value * runtime::BigInt(1000000007);
+    }
+    return ObjectHolder::Own(runtime::BigNumber(value));
+}
+
+// Вызывает из C++ метод объекта, возвращающий свой параметр
+void BenchClassInstanceCall() {
+    const ProgramClasses classes(CLASSES);
+    const ObjectHolder box = classes.NewInstance("Box"s);
+    auto &instance = *box.TryAs<runtime::ClassInstance>();
+    runtime::DummyContext context;
+    const vector<ObjectHolder> args{ObjectHolder::Own(runtime::Number(1))};
+
+    for (int i = 0; i < ITERATIONS; ++i) {
+        instance.Call("get"s, args, context);
+    }
+}
+
+// Сравнивает значения lhs и rhs функциями Equal и Less
+void CompareValues(const ObjectHolder &lhs, const ObjectHolder &rhs, int iterations) {
+    runtime::DummyContext context;
+    int equal = 0;
+    int less = 0;
+    for (int i = 0; i < iterations; ++i) {
+        equal += runtime::Equal(lhs, rhs, context) ? 1 : 0;
+        less += runtime::Less(lhs, rhs, context) ? 1 : 0;
+    }
+    if (equal != 0 || less != iterations) {
+        throw runtime_error("Unexpected comparison result");
+    }
+}
+
+void BenchCompareNumbers() {
+    CompareValues(ObjectHolder::Own(runtime::Number(1)), ObjectHolder::Own(runtime::Number(2)),
+                  ITERATIONS);
+}
+
+// Длинные строки с общим началом
+void BenchCompareStrings() {
+    const string prefix(100, 'a');
+    CompareValues(ObjectHolder::Own(runtime::String(prefix + "a"s)),
+                  ObjectHolder::Own(runtime::String(prefix + "b"s)), ITERATIONS);
+}
+
+void BenchCompareBigNumbers() {
+    const ObjectHolder big = MakeBigNumber();
+    CompareValues(ObjectHolder::Own(runtime::Number(1)), big, ITERATIONS);
+}
+
+// Объекты, сравниваемые методами __eq__ и __lt__
+void BenchCompareInstances() {
+    const ProgramClasses classes(CLASSES);
+    runtime::DummyContext context;
+    const ObjectHolder lhs = classes.NewInstance("Box"s);
+    const ObjectHolder rhs = classes.NewInstance("Box"s);
+    lhs.TryAs<runtime::ClassInstance>()->Fields()["value"s] = ObjectHolder::Own(runtime::Number(1));
+    rhs.TryAs<runtime::ClassInstance>()->Fields()["value"s] = ObjectHolder::Own(runtime::Number(2));
+    CompareValues(lhs, rhs, ITERATIONS / 4);
+}
+
+// Складывает значения переменных a и b узлом ast::Add
+void AddValues(ObjectHolder lhs, ObjectHolder rhs, int iterations) {
+    runtime::Closure closure;
+    closure["a"s] = std::move(lhs);
+    closure["b"s] = std::move(rhs);
+    ast::Add add(make_unique<ast::VariableValue>("a"s), make_unique<ast::VariableValue>("b"s));
+    runtime::DummyContext context;
+    for (int i = 0; i < iterations; ++i) {
+        if (!add.Execute(closure, context)) {
+            throw runtime_error("Empty sum");
+        }
+    }
+}
+
+void BenchAddNumbers() {
+    AddValues(ObjectHolder::Own(runtime::Number(1)), ObjectHolder::Own(runtime::Number(2)),
+              ITERATIONS);
+}
+
+void BenchAddNumberToBigNumber() {
+    AddValues(ObjectHolder::Own(runtime::Number(1)), MakeBigNumber(), ITERATIONS);
+}
+
+void BenchAddStrings() {
+    AddValues(ObjectHolder::Own(runtime::String("Hello, "s)),
+              ObjectHolder::Own(runtime::String("world"s)), ITERATIONS);
+}
+
+void BenchAddLists() {
+    runtime::List list;
+    for (int i = 0; i < 4; ++i) {
+        list.Append(ObjectHolder::Own(runtime::Number(i)));
+    }
+    AddValues(ObjectHolder::Own(runtime::List(list)), ObjectHolder::Own(runtime::List(list)),
+              ITERATIONS);
+}
+
+// Сложение объектов методом __add__
+void BenchAddInstances() {
+    const ProgramClasses classes(CLASSES);
+    const ObjectHolder lhs = classes.NewInstance("Box"s);
+    const ObjectHolder rhs = classes.NewInstance("Box"s);
+    lhs.TryAs<runtime::ClassInstance>()->Fields()["value"s] = ObjectHolder::Own(runtime::Number(1));
+    rhs.TryAs<runtime::ClassInstance>()->Fields()["value"s] = ObjectHolder::Own(runtime::Number(2));
+    AddValues(lhs, rhs, ITERATIONS / 4);
+}
+
+// Выводит командой print число, строку, логическое значение и короткий список
+void BenchPrint() {
+    runtime::Closure closure;
+    closure["n"s] = ObjectHolder::Own(runtime::Number(1234567));
+    closure["s"s] = ObjectHolder::Own(runtime::String("Hello, world"s));
+    closure["b"s] = ObjectHolder::Own(runtime::Bool(true));
+    runtime::List list;
+    for (int i = 0; i < 4; ++i) {
+        list.Append(ObjectHolder::Own(runtime::Number(i)));
+    }
+    closure["l"s] = ObjectHolder::Own(std::move(list));
+
+    vector<unique_ptr<ast::Statement>> args;
+    for (const char *name : {"n", "s", "b", "l"}) {
+        args.push_back(make_unique<ast::VariableValue>(string(name)));
+    }
+    ast::Print print(std::move(args));
+
+    NullBuffer buffer;
+    ostream output(&buffer);
+    runtime::SimpleContext context{output};
+    for (int i = 0; i < ITERATIONS / 2; ++i) {
+        print.Execute(closure, context);
+    }
+}
+
+// Глобальные переменные, общие для всех запросов
+runtime::Closure MakeGlobals() {
+    runtime::Closure globals;
+    for (int i = 0; i < 1000; ++i) {
+        globals["v"s + to_string(i)] = ObjectHolder::Own(runtime::Number(i));
+    }
+    return globals;
+}
+
+// Каждый запрос копирует таблицу и изменяет одну переменную
+void BenchClosureCopy() {
+    const runtime::Closure globals = MakeGlobals();
+    for (int i = 0; i < ITERATIONS / 1000; ++i) {
+        runtime::Closure request = globals;
+        request["v0"s] = ObjectHolder::Own(runtime::Number(i));
+    }
+}
+
+// То же, но запрос получает таблицу над общим замороженным слоем
+void BenchClosureFork() {
+    runtime::Closure globals = MakeGlobals();
+    for (int i = 0; i < ITERATIONS / 1000; ++i) {
+        runtime::Closure request = globals.Fork();
+        request["v0"s] = ObjectHolder::Own(runtime::Number(i));
+    }
+}
+
+} // namespace
+
+void RunRuntimeBenchmarks(BenchRunner &br) {
+    RUN_BENCH(br, BenchClassInstanceCall);
+    RUN_BENCH(br, BenchCompareNumbers);
+    RUN_BENCH(br, BenchCompareStrings);
+    RUN_BENCH(br, BenchCompareBigNumbers);
+    RUN_BENCH(br, BenchCompareInstances);
+    RUN_BENCH(br, BenchAddNumbers);
+    RUN_BENCH(br, BenchAddNumberToBigNumber);
+    RUN_BENCH(br, BenchAddStrings);
+    RUN_BENCH(br, BenchAddLists);
+    RUN_BENCH(br, BenchAddInstances);
+    RUN_BENCH(br, BenchPrint);
+    RUN_BENCH(br, BenchClosureCopy);
+    RUN_BENCH(br, BenchClosureFork);
+}
@@ -0,0 +1,33 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+namespace {
+
+string ReadFile(const string &path) {
+    ifstream input(path);
+    if (!input) {
+        throw runtime_error("Can't open " + path);
+    }
+    return {istreambuf_iterator<char>(input), istreambuf_iterator<char>()};
+}
+
+// Разбирает и исполняет app/example/script.my 2000 раз
+void BenchExampleScript() {
+    const string program = ReadFile(MYTHON_EXAMPLE_SCRIPT);
+    for (int i = 0; i < 2000; ++i) {
+        ExpectOutput(program,
+                     "Факториал числа 10 равен 3628800\n"
+                     "Число Фибоначи для числа 10 равно 55\n");
+    }
+}
+
+} // namespace
+
+void RunScriptBenchmarks(BenchRunner &br) {
+    RUN_BENCH(br, BenchExampleScript);
+}
@@ -0,0 +1,57 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+#include "snapshot.h"
+#include "workload.h"
+
+using namespace std;
+
+namespace {
+
+constexpr int REQUESTS = 100;
+
+// Пролог - синтетическая программа: несколько сотен классов и объектов
+const string &Prelude() {
+    static const string prelude = workload::Generate(workload::Parameters{}.Scale(10)).program;
+    return prelude;
+}
+
+const string REQUEST = "print total, deepest.base()\n"s;
+
+// Каждый запрос разбирает и исполняет пролог заново
+void BenchPreludePerRequest() {
+    for (int i = 0; i < REQUESTS; ++i) {
+        if (RunMythonProgram(Prelude() + REQUEST).empty()) {
+            throw runtime_error("Empty output");
+        }
+    }
+}
+
+// Пролог исполняется один раз, каждый запрос начинается с копии снимка
+void BenchSnapshotFork() {
+    istringstream input(Prelude());
+    parse::Lexer lexer(input);
+    runtime::DummyContext prelude_context;
+    const runtime::Snapshot snapshot(ParseProgram(lexer), prelude_context);
+
+    istringstream request_input(REQUEST);
+    parse::Lexer request_lexer(request_input);
+    const auto request = ParseProgram(request_lexer, snapshot.GetGlobals());
+    for (int i = 0; i < REQUESTS; ++i) {
+        runtime::Closure globals = snapshot.Fork();
+        ostringstream output;
+        runtime::SimpleContext context{output};
+        request->Execute(globals, context);
+        if (output.str().empty()) {
+            throw runtime_error("Empty output");
+        }
+    }
+}
+
+} // namespace
+
+void RunSnapshotBenchmarks(BenchRunner &br) {
+    Prelude();
+
+    RUN_BENCH(br, BenchPreludePerRequest);
+    RUN_BENCH(br, BenchSnapshotFork);
+}
@@ -0,0 +1,111 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+
+#include <string>
+
+using namespace std;
+
+namespace {
+
+// Сравнивает 1 000 000 раз длинные строки: одну и ту же и совпадающие по длине
+void BenchStringEquality() {
+    ExpectOutput(R"(
+a = 'a long string which does not fit into the inline buffer'
+b = a
+c = 'a long string which does not fit into the inline buffeR'
+same = 0
+for i in range(0, 1000000):
+  if a == b:
+    same = same + 1
+  if a == c:
+    same = same + 1
+print same
+)",
+                 "1000000\n");
+}
+
+// Передаёт длинную строку через поля и параметры методов
+void BenchStringPassing() {
+    ExpectOutput(R"(
+class Holder:
+  def set(value):
+    self.value = value
+    return value
+
+h = Holder()
+text = 'a long string which does not fit into the inline buffer'
+for i in range(0, 1000000):
+  text = h.set(text)
+print len(text)
+)",
+                 "55\n");
+}
+
+// Склеивает короткие строки, умещающиеся в объект
+void BenchShortConcat() {
+    ExpectOutput(R"(
+n = 0
+for i in range(0, 1000000):
+  s = 'ab' + 'cd'
+  n = n + len(s)
+print n
+)",
+                 "4000000\n");
+}
+
+// Собирает строку из count частей циклом s = s + piece. Время должно расти линейно
+void BuildString(int count) {
+    const string count_str = to_string(count);
+    ExpectOutput(R"(
+s = ''
+for i in range(0, )" + count_str + R"():
+  s = s + 'piece of text '
+print len(s)
+)",
+                 to_string(count * 14) + "\n");
+}
+
+void BenchConcat25k() {
+    BuildString(25000);
+}
+
+void BenchConcat50k() {
+    BuildString(50000);
+}
+
+void BenchConcat100k() {
+    BuildString(100000);
+}
+
+// Формирует строки отчёта через str() от чисел, логических значений и объектов с __str__
+void BenchStrReport() {
+    ExpectOutput(R"(
+class Point:
+  def __init__(x, y):
+    self.x = x
+    self.y = y
+
+  def __str__():
+    return str(self.x) + ',' + str(self.y)
+
+total = 0
+for i in range(0, 300000):
+  p = Point(i, -i)
+  row = str(i) + ';' + str(p) + ';' + str(i < 100000)
+  total = total + len(row)
+print total
+)",
+                 "7666669\n");
+}
+
+} // namespace
+
+void RunStringBenchmarks(BenchRunner &br) {
+    RUN_BENCH(br, BenchStringEquality);
+    RUN_BENCH(br, BenchStringPassing);
+    RUN_BENCH(br, BenchShortConcat);
+    RUN_BENCH(br, BenchConcat25k);
+    RUN_BENCH(br, BenchConcat50k);
+    RUN_BENCH(br, BenchConcat100k);
+    RUN_BENCH(br, BenchStrReport);
+}
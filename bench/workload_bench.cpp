@@ -0,0 +1,51 @@
+#include "bench_runner.h"
+#include "mython_program.h"
+#include "workload.h"
+
+#include <map>
+
+using namespace std;
+
+namespace {
+
+const workload::Workload &ScaledWorkload(size_t scale) {
+    static map<size_t, workload::Workload> workloads;
+    auto it = workloads.find(scale);
+    if (it == workloads.end()) {
+        it = workloads.emplace(scale, workload::Generate(workload::Parameters{}.Scale(scale))).first;
+    }
+    return it->second;
+}
+
+// Разбирает и исполняет синтетическую программу, проверяя её вывод
+void RunWorkload(size_t scale, int repetitions) {
+    const auto &generated = ScaledWorkload(scale);
+    for (int i = 0; i < repetitions; ++i) {
+        ExpectOutput(generated.program, generated.expected_output);
+    }
+}
+
+void BenchWorkload10x() {
+    RunWorkload(10, 20);
+}
+
+void BenchWorkload100x() {
+    RunWorkload(100, 2);
+}
+
+void BenchWorkload1000x() {
+    RunWorkload(1000, 1);
+}
+
+} // namespace
+
+void RunWorkloadBenchmarks(BenchRunner &br) {
+    // Программы строятся до замеров
+    for (const size_t scale : {10, 100, 1000}) {
+        ScaledWorkload(scale);
+    }
+
+    RUN_BENCH(br, BenchWorkload10x);
+    RUN_BENCH(br, BenchWorkload100x);
+    RUN_BENCH(br, BenchWorkload1000x);
+}
@@ -0,0 +1,109 @@
+#include "workload.h"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+struct Options {
+    // Размеры частей: значения по умолчанию, умноженные на --scale, с явно заданными поверх
+    workload::Parameters parameters;
+    // Файл для программы; пустая строка - стандартный вывод
+    string program_path;
+    // Файл для ожидаемого вывода программы
+    string expected_path;
+};
+
+void PrintUsage() {
+    cerr << "Usage: mython_gen [--scale=K] [--classes=N] [--inheritance-depth=N]\n"
+            "                  [--method-statements=N] [--field-chain=N] [--recursion-depth=N]\n"
+            "                  [--tail-recursion-depth=N] [--output=program.my]\n"
+            "                  [--expected=program.out]\n"sv;
+}
+
+pair<string_view, string> SplitOption(string_view arg) {
+    const auto eq = arg.find('=');
+    if (eq == string_view::npos || eq + 1 == arg.size()) {
+        throw invalid_argument("Unknown option "s + string(arg));
+    }
+    return {arg.substr(0, eq), string(arg.substr(eq + 1))};
+}
+
+// --scale применяется к значениям по умолчанию независимо от положения в командной строке,
+// а явно заданные размеры частей не масштабируются
+Options ParseOptions(int argc, char *argv[]) {
+    size_t scale = 1;
+    for (int i = 1; i < argc; ++i) {
+        const auto [name, value] = SplitOption(argv[i]);
+        if (name == "--scale"sv) {
+            scale = stoul(value);
+        }
+    }
+
+    Options options;
+    auto &parameters = options.parameters;
+    parameters = parameters.Scale(scale);
+    for (int i = 1; i < argc; ++i) {
+        const auto [name, value] = SplitOption(argv[i]);
+        if (name == "--scale"sv) {
+            continue;
+        }
+        if (name == "--output"sv) {
+            options.program_path = value;
+        } else if (name == "--expected"sv) {
+            options.expected_path = value;
+        } else if (name == "--classes"sv) {
+            parameters.classes = stoul(value);
+        } else if (name == "--inheritance-depth"sv) {
+            parameters.inheritance_depth = stoul(value);
+        } else if (name == "--method-statements"sv) {
+            parameters.method_statements = stoul(value);
+        } else if (name == "--field-chain"sv) {
+            parameters.field_chain = stoul(value);
+        } else if (name == "--recursion-depth"sv) {
+            parameters.recursion_depth = stoul(value);
+        } else if (name == "--tail-recursion-depth"sv) {
+            parameters.tail_recursion_depth = stoul(value);
+        } else {
+            throw invalid_argument("Unknown option "s + argv[i]);
+        }
+    }
+    return options;
+}
+
+void WriteFile(const string &path, const string &content) {
+    ofstream output(path, ios::binary);
+    output << content;
+    if (!output) {
+        throw runtime_error("Can't write "s + path);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        const Options options = ParseOptions(argc, argv);
+        const auto generated = workload::Generate(options.parameters);
+
+        if (options.program_path.empty()) {
+            cout << generated.program;
+        } else {
+            WriteFile(options.program_path, generated.program);
+        }
+        if (!options.expected_path.empty()) {
+            WriteFile(options.expected_path, generated.expected_output);
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        PrintUsage();
+        return 1;
+    }
+    return 0;
+}
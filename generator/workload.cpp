@@ -0,0 +1,168 @@
+#include "workload.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace workload {
+
+namespace {
+
+// Сумма чисел от 0 до n
+std::int64_t Sum(size_t n) {
+    const auto value = static_cast<std::int64_t>(n);
+    return value * (value + 1) / 2;
+}
+
+// Классы Item0, Item1, ... с полем и методом; программа суммирует значения их объектов
+void AddClasses(size_t count, Workload &workload) {
+    string &program = workload.program;
+    std::int64_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const string index = to_string(i);
+        program += "class Item" + index + ":\n"
+                   "  def __init__():\n"
+                   "    self.weight = " + to_string(i % 10) + "\n"
+                   "\n"
+                   "  def value():\n"
+                   "    return " + index + " + self.weight\n"
+                   "\n";
+        total += static_cast<std::int64_t>(i + i % 10);
+    }
+    program += "total = 0\n";
+    for (size_t i = 0; i < count; ++i) {
+        program += "item = Item" + to_string(i) + "()\n"
+                   "total = total + item.value()\n";
+    }
+    program += "print 'classes', total\n";
+    workload.expected_output += "classes " + to_string(total) + "\n";
+}
+
+// Цепочка Level0 <- Level1 <- ... Каждый класс объявляет свой метод stepK, а объект последнего
+// класса вызывает методы всех предков
+void AddInheritanceChain(size_t depth, Workload &workload) {
+    string &program = workload.program;
+    for (size_t k = 0; k < depth; ++k) {
+        const string index = to_string(k);
+        program += "class Level" + index;
+        if (k > 0) {
+            program += "(Level" + to_string(k - 1) + ")";
+        }
+        program += ":\n";
+        if (k == 0) {
+            program += "  def base():\n"
+                       "    return 'root'\n"
+                       "\n";
+        }
+        program += "  def step" + index + "():\n"
+                   "    return " + index + "\n"
+                   "\n";
+    }
+    program += "deepest = Level" + to_string(depth - 1) + "()\n"
+               "total = 0\n";
+    for (size_t k = 0; k < depth; ++k) {
+        program += "total = total + deepest.step" + to_string(k) + "()\n";
+    }
+    program += "print 'inheritance', deepest.base(), total\n";
+    workload.expected_output += "inheritance root " + to_string(Sum(depth - 1)) + "\n";
+}
+
+// Метод из statements инструкций: сложения, перемежающиеся условиями
+void AddLongMethod(size_t statements, Workload &workload) {
+    string &program = workload.program;
+    program += "class Big:\n"
+               "  def run(x):\n";
+    std::int64_t x = 0;
+    for (size_t j = 0; j < statements; ++j) {
+        if (j % 5 == 4) {
+            program += "    if x > 1000:\n"
+                       "      x = x - 1000\n";
+            if (x > 1000) {
+                x -= 1000;
+            }
+        } else {
+            const auto step = static_cast<std::int64_t>(j % 7 + 1);
+            program += "    x = x + " + to_string(step) + "\n";
+            x += step;
+        }
+    }
+    program += "    return x\n"
+               "\n"
+               "big = Big()\n"
+               "print 'method', big.run(0)\n";
+    workload.expected_output += "method " + to_string(x) + "\n";
+}
+
+// Связный список из length + 1 узлов и выражение head.next.next...next.value
+void AddFieldChain(size_t length, Workload &workload) {
+    string &program = workload.program;
+    program += "class Node:\n"
+               "  def __init__(value):\n"
+               "    self.value = value\n"
+               "    self.next = None\n"
+               "\n"
+               "head = Node(0)\n"
+               "node = head\n"
+               "for i in range(1, " + to_string(length + 1) + "):\n"
+               "  link = Node(i)\n"
+               "  node.next = link\n"
+               "  node = link\n"
+               "print 'fields', head";
+    for (size_t i = 0; i < length; ++i) {
+        program += ".next";
+    }
+    program += ".value\n";
+    workload.expected_output += "fields " + to_string(length) + "\n";
+}
+
+// Обычная и хвостовая рекурсия, суммирующие числа от 0 до n
+void AddRecursion(size_t depth, size_t tail_depth, Workload &workload) {
+    workload.program += "class Recursion:\n"
+                        "  def sum(n):\n"
+                        "    if n == 0:\n"
+                        "      return 0\n"
+                        "    return n + self.sum(n - 1)\n"
+                        "\n"
+                        "  def count(n, acc):\n"
+                        "    if n == 0:\n"
+                        "      return acc\n"
+                        "    return self.count(n - 1, acc + n)\n"
+                        "\n"
+                        "recursion = Recursion()\n"
+                        "print 'recursion', recursion.sum(" + to_string(depth) + "), "
+                        "recursion.count(" + to_string(tail_depth) + ", 0)\n";
+    workload.expected_output +=
+        "recursion " + to_string(Sum(depth)) + " " + to_string(Sum(tail_depth)) + "\n";
+}
+
+} // namespace
+
+Parameters Parameters::Scale(size_t factor) const {
+    Parameters result = *this;
+    result.classes *= factor;
+    result.inheritance_depth *= factor;
+    result.method_statements *= factor;
+    result.field_chain *= factor;
+    result.recursion_depth = std::max(
+        recursion_depth, std::min(recursion_depth * factor, MAX_SCALED_RECURSION_DEPTH));
+    result.tail_recursion_depth *= factor;
+    return result;
+}
+
+Workload Generate(const Parameters &parameters) {
+    Workload workload;
+    if (parameters.classes > 0) {
+        AddClasses(parameters.classes, workload);
+    }
+    if (parameters.inheritance_depth > 0) {
+        AddInheritanceChain(parameters.inheritance_depth, workload);
+    }
+    if (parameters.method_statements > 0) {
+        AddLongMethod(parameters.method_statements, workload);
+    }
+    AddFieldChain(parameters.field_chain, workload);
+    AddRecursion(parameters.recursion_depth, parameters.tail_recursion_depth, workload);
+    return workload;
+}
+
+} // namespace workload
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace workload {
+
+// Размеры частей синтетической программы. Значения по умолчанию соответствуют размерам
+// программ из test/*.cpp, Scale умножает их все
+struct Parameters {
+    // Количество независимых классов, объекты которых создаются и опрашиваются
+    size_t classes = 20;
+    // Длина цепочки наследования: каждый класс цепочки унаследован от предыдущего
+    size_t inheritance_depth = 5;
+    // Количество инструкций в теле одного метода
+    size_t method_statements = 50;
+    // Длина цепочки полей a.next.next...next.value
+    size_t field_chain = 5;
+    // Глубина обычной (не хвостовой) рекурсии. Scale не увеличивает её больше
+    // MAX_SCALED_RECURSION_DEPTH
+    size_t recursion_depth = 50;
+    // Глубина хвостовой рекурсии, которая исполняется без роста стека
+    size_t tail_recursion_depth = 500;
+
+    // Глубина обычной рекурсии, которая с запасом помещается в стек потока размером 8 МБ
+    static constexpr size_t MAX_SCALED_RECURSION_DEPTH = 1000;
+
+    [[nodiscard]] Parameters Scale(size_t factor) const;
+};
+
+// Программа на Mython и вывод, который она должна напечатать
+struct Workload {
+    std::string program;
+    std::string expected_output;
+};
+
+// Строит программу из частей заданных размеров. Каждая часть печатает одну строку с
+// названием и вычисленным значением, поэтому по выводу видно, какая часть ошиблась
+Workload Generate(const Parameters &parameters);
+
+} // namespace workload
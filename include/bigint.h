@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace runtime {
+
+/*
+ * Целое число произвольной длины.
+ * Модуль хранится в векторе 32-битных разрядов (limbs) от младшего к старшему без ведущих
+ * нулей, знак - отдельным флагом. У нуля нет разрядов и он не отрицателен.
+ * Длинные множители перемножаются алгоритмом Карацубы, короткие - «в столбик».
+ * Деление, как и у Number, округляет частное к нулю
+ */
+class BigInt {
+  public:
+    using Limb = std::uint32_t;
+
+    // Множители короче KARATSUBA_THRESHOLD разрядов перемножаются «в столбик»
+    static constexpr size_t KARATSUBA_THRESHOLD = 32;
+
+    BigInt() = default;
+    BigInt(std::int64_t value); // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+
+    // Возвращает неотрицательное число с десятичной записью digits - непустой строкой цифр
+    [[nodiscard]] static BigInt FromDecimal(std::string_view digits);
+
+    [[nodiscard]] bool IsZero() const {
+        return limbs_.empty();
+    }
+    [[nodiscard]] bool IsNegative() const {
+        return negative_;
+    }
+
+    // Возвращает true, если число умещается в std::int64_t
+    [[nodiscard]] bool FitsInt64() const;
+    // Возвращает значение числа. Число должно умещаться в std::int64_t
+    [[nodiscard]] std::int64_t ToInt64() const;
+
+    // Возвращает десятичную запись числа
+    [[nodiscard]] std::string ToString() const;
+
+    [[nodiscard]] std::uint64_t Hash() const;
+
+    // Возвращает -1, 0 или 1, если lhs меньше, равно или больше rhs
+    [[nodiscard]] static int Compare(const BigInt &lhs, const BigInt &rhs);
+
+    BigInt operator-() const;
+
+    friend BigInt operator+(const BigInt &lhs, const BigInt &rhs);
+    friend BigInt operator-(const BigInt &lhs, const BigInt &rhs);
+    friend BigInt operator*(const BigInt &lhs, const BigInt &rhs);
+    // При делении на ноль выбрасывает runtime_error
+    friend BigInt operator/(const BigInt &lhs, const BigInt &rhs);
+
+    friend bool operator==(const BigInt &lhs, const BigInt &rhs) {
+        return lhs.negative_ == rhs.negative_ && lhs.limbs_ == rhs.limbs_;
+    }
+    friend bool operator!=(const BigInt &lhs, const BigInt &rhs) {
+        return !(lhs == rhs);
+    }
+    friend bool operator<(const BigInt &lhs, const BigInt &rhs) {
+        return Compare(lhs, rhs) < 0;
+    }
+
+  private:
+    BigInt(std::vector<Limb> limbs, bool negative);
+
+    std::vector<Limb> limbs_;
+    bool negative_ = false;
+};
+
+std::ostream &operator<<(std::ostream &os, const BigInt &value);
+
+} // namespace runtime
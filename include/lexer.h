@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <iosfwd>
 #include <optional>
 #include <sstream>
@@ -11,7 +12,11 @@ namespace parse {
 
 namespace token_type {
 struct Number { // Лексема «число»
-    int value;  // число
+    std::int64_t value;  // число
+};
+
+struct BigNumber {     // Лексема «число, не умещающееся в 64 бита»
+    std::string value; // Десятичная запись числа
 };
 
 struct Id {            // Лексема «идентификатор»
@@ -30,7 +35,11 @@ struct Class {};   // Лексема «class»
 struct Return {};  // Лексема «return»
 struct If {};      // Лексема «if»
 struct Else {};    // Лексема «else»
+struct While {};   // Лексема «while»
+struct For {};     // Лексема «for»
+struct In {};      // Лексема «in»
 struct Def {};     // Лексема «def»
+struct Import {};  // Лексема «import»
 struct Newline {}; // Лексема «конец строки»
 struct Print {};   // Лексема «print»
 struct Indent {}; // Лексема «увеличение отступа», соответствует двум пробелам
@@ -49,6 +58,7 @@ struct False {};       // Лексема «False»
 } // namespace token_type
 
 using TokenBase = std::variant<token_type::Number,
+                               token_type::BigNumber,
                                token_type::Id,
                                token_type::Char,
                                token_type::String,
@@ -56,7 +66,11 @@ using TokenBase = std::variant<token_type::Number,
                                token_type::Return,
                                token_type::If,
                                token_type::Else,
+                               token_type::While,
+                               token_type::For,
+                               token_type::In,
                                token_type::Def,
+                               token_type::Import,
                                token_type::Newline,
                                token_type::Print,
                                token_type::Indent,
@@ -104,13 +118,19 @@ class LexerError : public std::runtime_error {
 
 class Lexer {
   public:
-    explicit Lexer(std::istream &input);
+    // first_line - номер первой строки input в программе, если input - часть программы
+    explicit Lexer(std::istream &input, size_t first_line = 1);
 
     // Возвращает ссылку на текущий токен или token_type::Eof, если поток токенов закончился
     [[nodiscard]] const Token &CurrentToken() const {
         return current_token_;
     }
 
+    // Возвращает номер строки программы (с единицы), на которой находится текущий токен
+    [[nodiscard]] size_t CurrentLine() const {
+        return current_line_;
+    }
+
     // Возвращает следующий токен, либо token_type::Eof, если поток токенов закончился
     Token NextToken();
 
@@ -166,6 +186,11 @@ class Lexer {
     std::istream &input_;
     Token current_token_;
     int indent_level_;
+    // Отступ предыдущей строки в уровнях по два пробела
+    int prev_indent_ = 0;
+    // Номер строки, на которой находится следующий непрочитанный символ
+    size_t line_ = 1;
+    size_t current_line_ = 1;
 };
 
 } // namespace parse
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "snapshot.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace runtime {
+
+/*
+ * Кэш модулей, подключаемых командой import. Модуль name - файл name.my в одном из каталогов
+ * пути поиска. Модуль разбирается и исполняется один раз, а его глобальные переменные хранятся
+ * в Snapshot, общем для всех программ и потоков процесса. Команда import копирует переменные
+ * снимка в переменные программы (см. Snapshot::Fork), а классы модуля известны разбору
+ * программы так же, как объявленные в ней самой.
+ *
+ * При каждом обращении к модулю проверяются время изменения и размер его файла. Изменённый
+ * модуль и модули, импортирующие его, загружаются заново при следующем обращении; программы,
+ * разобранные раньше, продолжают использовать прежнюю версию.
+ *
+ * Модуль исполняется в контексте, последним созданном в потоке, который разбирает
+ * импортирующую программу: шаги и память модуля учитываются в ограничениях (ExecutionLimits)
+ * этого контекста вместе с шагами и памятью программы, а вывод команд print верхнего уровня
+ * модуля попадает в его поток вывода. Чтобы ограничения программы действовали и на модули, её
+ * разбирают после создания контекста её исполнения. Если контекста нет, модуль исполняется без
+ * ограничений, а его вывод отбрасывается.
+ *
+ * Методы кэша можно вызывать из нескольких потоков: загрузка модулей выполняется под мьютексом
+ */
+class ModuleCache {
+  public:
+    static constexpr std::string_view EXTENSION = ".my";
+
+    // Возвращает кэш процесса. По умолчанию модули ищутся в текущем каталоге
+    static ModuleCache &Instance();
+
+    ModuleCache() = default;
+    ModuleCache(const ModuleCache &) = delete;
+    ModuleCache &operator=(const ModuleCache &) = delete;
+
+    // Задаёт каталоги, в которых ищутся файлы модулей, в порядке просмотра
+    void SetSearchPath(std::vector<std::filesystem::path> directories);
+
+    // Возвращает снимок модуля name, загружая модуль, если он ещё не загружен или его файл
+    // изменился. Если файл не найден или модули импортируют друг друга по кругу, выбрасывает
+    // ParseError; ошибки разбора и исполнения модуля передаются вызывающему с тем же типом и
+    // именем модуля в начале сообщения
+    [[nodiscard]] std::shared_ptr<const Snapshot> Load(const std::string &name);
+
+    // Количество загрузок (разборов и исполнений файлов модулей) за всё время работы кэша
+    [[nodiscard]] size_t GetLoadCount() const;
+
+    // Забывает все загруженные модули
+    void Clear();
+
+  private:
+    // Время изменения и размер файла модуля
+    struct FileStamp {
+        std::filesystem::file_time_type mtime;
+        std::uintmax_t size = 0;
+
+        bool operator==(const FileStamp &other) const {
+            return mtime == other.mtime && size == other.size;
+        }
+    };
+
+    struct Module {
+        std::filesystem::path path;
+        FileStamp stamp;
+        std::shared_ptr<const Snapshot> snapshot;
+        // Модули, импортированные при загрузке, и их версии
+        std::vector<std::pair<std::string, std::shared_ptr<const Snapshot>>> imports;
+    };
+
+    [[nodiscard]] std::filesystem::path FindFile(const std::string &name) const;
+    // Возвращает снимок актуальной версии модуля, при необходимости загружая его
+    [[nodiscard]] std::shared_ptr<const Snapshot> GetCurrent(const std::string &name);
+    // Возвращает true, если ни файл модуля, ни импортированные им модули не изменились
+    [[nodiscard]] bool IsCurrent(const Module &module);
+    [[nodiscard]] Module LoadFile(const std::string &name);
+
+    // Рекурсивный: загрузка модуля загружает импортированные им модули
+    mutable std::recursive_mutex mutex_;
+    std::vector<std::filesystem::path> search_path_{"."};
+    std::unordered_map<std::string, Module> modules_;
+    // Модули, загружаемые в данный момент, от внешнего к внутреннему
+    std::vector<Module *> loading_;
+    std::unordered_set<std::string> loading_names_;
+    size_t load_count_ = 0;
+};
+
+} // namespace runtime
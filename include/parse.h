@@ -1,18 +1,80 @@
 #pragma once
 
+#include "runtime.h"
+
 #include <memory>
 #include <stdexcept>
+#include <string_view>
+#include <vector>
 
 namespace parse {
 class Lexer;
 }
 
-namespace runtime {
-class Executable;
-}
-
 struct ParseError : std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
-std::unique_ptr<runtime::Executable> ParseProgram(parse::Lexer &lexer);
\ No newline at end of file
+std::unique_ptr<runtime::Executable> ParseProgram(parse::Lexer &lexer);
+
+// Разбирает программу, которая будет выполняться с глобальными переменными globals (например,
+// копией Snapshot): классы из globals можно создавать и наследовать, как объявленные в самой
+// программе. Программа ссылается на эти классы, поэтому они должны пережить её
+std::unique_ptr<runtime::Executable> ParseProgram(parse::Lexer &lexer,
+                                                  const runtime::Closure &globals);
+
+// Определения классов, идущие подряд, разбираются параллельно, если их текст не короче
+// PARALLEL_PARSE_MIN_BYTES
+inline constexpr size_t PARALLEL_PARSE_MIN_BYTES = 64 * 1024;
+
+// Разбирает программу source так же, как ParseProgram(lexer), но определения классов верхнего
+// уровня разбирает в threads потоках (0 - по числу ядер процессора). Независимые классы
+// разбираются одновременно, а класс, в методах или заголовке которого упоминается другой класс
+// программы, - после него. Ошибочная программа разбирается заново последовательно, чтобы
+// сообщить о первой ошибке. При threads == 1 программа разбирается последовательно
+std::unique_ptr<runtime::Executable> ParseProgram(std::string_view source, size_t threads = 0);
+
+/*
+ * Разбирает последовательные версии одной программы, например файла, который правит автор.
+ * Программа делится на те же части, что и при параллельном разборе: определения классов
+ * верхнего уровня и идущие подряд прочие инструкции. Часть, текст которой есть в прошлой
+ * версии, заново не разбирается, если не изменились и классы, которые она создаёт или
+ * наследует: новая версия разделяет с прежней её синтаксическое дерево и объявленный в ней
+ * класс вместе с методами. Если часть сместилась из-за вставки или удаления строк выше неё,
+ * номера строк её инструкций сдвигаются. Части с командой import разбираются всегда, чтобы
+ * заметить изменение модуля.
+ *
+ * Программы, возвращённые Parse, независимы: прежнюю версию можно исполнять и после разбора
+ * новой, но номера строк её общих с новой версией частей, которые видит профилировщик,
+ * становятся номерами строк новой версии. Объект используется в одном потоке
+ */
+class IncrementalParser {
+  public:
+    struct Stats {
+        // Части, разобранные заново
+        size_t parsed = 0;
+        // Части, взятые из прежней версии
+        size_t reused = 0;
+    };
+
+    IncrementalParser();
+    ~IncrementalParser();
+
+    IncrementalParser(const IncrementalParser &) = delete;
+    IncrementalParser &operator=(const IncrementalParser &) = delete;
+
+    // Разбирает очередную версию программы. Ошибку разбора сообщает так же, как
+    // ParseProgram(lexer); следующая версия тогда сравнивается с последней разобранной без ошибок
+    std::unique_ptr<runtime::Executable> Parse(std::string_view source);
+
+    // Статистика последнего вызова Parse
+    [[nodiscard]] const Stats &GetStats() const {
+        return stats_;
+    }
+
+  private:
+    struct ParsedChunk;
+
+    std::vector<std::shared_ptr<ParsedChunk>> chunks_;
+    Stats stats_;
+};
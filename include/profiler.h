@@ -0,0 +1,72 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace runtime {
+
+/*
+ * Выборочный профилировщик программ на Mython. Поток профилировщика через равные промежутки
+ * времени копирует стек вызовов CallStack профилируемого потока и подсчитывает одинаковые
+ * стеки. Профилируемый поток не останавливается и не выполняет дополнительной работы.
+ * Выборки делаются по астрономическому времени, поэтому ожидание ввода-вывода тоже попадает
+ * в профиль.
+ *
+ * Отчёт выводится в формате свёрнутых стеков (folded stacks), который понимают flamegraph.pl
+ * и speedscope: записи стека от внешней к внутренней через точку с запятой и число выборок
+ *     <module>:12;Fibonacci.calc:5;Fibonacci.calc:6 42
+ * Профилировщик хранит указатели на классы и методы, поэтому отчёт нужно получить до
+ * уничтожения программы
+ */
+class Profiler {
+  public:
+    static constexpr std::chrono::microseconds DEFAULT_INTERVAL{1000};
+
+    explicit Profiler(const CallStack &calls,
+                      std::chrono::microseconds interval = DEFAULT_INTERVAL);
+    ~Profiler();
+
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    // Запускает поток профилировщика
+    void Start();
+    // Останавливает поток профилировщика и дожидается его завершения
+    void Stop();
+
+    // Добавляет в профиль текущее состояние стека вызовов
+    void TakeSample();
+
+    [[nodiscard]] size_t GetSampleCount() const;
+
+    // Выводит свёрнутые стеки, по одному в строке, в лексикографическом порядке
+    void WriteFolded(std::ostream &output) const;
+
+  private:
+    struct FramesLess {
+        bool operator()(const std::vector<CallStack::Frame> &lhs,
+                        const std::vector<CallStack::Frame> &rhs) const;
+    };
+
+    void TakeSampleLocked();
+
+    const CallStack &calls_;
+    std::chrono::microseconds interval_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable stop_requested_;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    std::map<std::vector<CallStack::Frame>, size_t, FramesLess> stacks_;
+    size_t samples_ = 0;
+};
+
+} // namespace runtime
@@ -1,21 +1,104 @@
 #pragma once
 
+#include "bigint.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <list>
 #include <memory>
+#include <new>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace runtime {
 
-// Контекст исполнения инструкций Mython
-class Context {
+class Class;
+class ClassInstance;
+class Context;
+class GarbageCollector;
+struct Method;
+
+// Счётчик ссылок на объект. По умолчанию интерпретатор однопоточный и счётчик обычный;
+// при сборке с MYTHON_ATOMIC_REFCOUNT объекты можно разделять между потоками.
+// При копировании объекта счётчик не копируется: копия - новый объект без владельцев
+class RefCount {
   public:
-    // Возвращает поток вывода для команд print
-    virtual std::ostream &GetOutputStream() = 0;
+    RefCount() = default;
+    RefCount(const RefCount & /*other*/) noexcept {}
+    RefCount &operator=(const RefCount & /*other*/) noexcept {
+        return *this;
+    }
 
-  protected:
-    ~Context() = default;
+    size_t operator++() noexcept {
+        return ++value_;
+    }
+    size_t operator--() noexcept {
+        return --value_;
+    }
+    [[nodiscard]] size_t Get() const noexcept {
+        return value_;
+    }
+
+  private:
+#ifdef MYTHON_ATOMIC_REFCOUNT
+    std::atomic<size_t> value_{0};
+#else
+    size_t value_ = 0;
+#endif
+};
+
+/*
+ * Учёт памяти, которую интерпретатор выделяет для значений программы в текущем потоке:
+ * объекты, символы длинных строк, элементы списков и словарей, таблицы Closure и массивы
+ * фактических параметров. Освобождение учитывается в потоке, который освобождает память.
+ * Контекст исполнения отсчитывает использование памяти от значения на момент своего создания,
+ * запоминает наибольшее значение и ограничивает его квотой ExecutionLimits::max_memory
+ */
+class MemoryUsage {
+  public:
+    // Учитывает выделение size байт. Если выделение превышает квоту текущего контекста,
+    // выбрасывает ExecutionLimitExceeded и не учитывает его
+    static void Allocate(size_t size) {
+        bytes_ += static_cast<std::int64_t>(size);
+        if (bytes_ > watermark_) {
+            OnNewPeak(size);
+        }
+    }
+
+    static void Release(size_t size) noexcept {
+        bytes_ -= static_cast<std::int64_t>(size);
+    }
+
+    // Память, занятая в текущем потоке. Может быть отрицательной, если поток освободил
+    // память, выделенную в другом потоке
+    [[nodiscard]] static std::int64_t Current() noexcept {
+        return bytes_;
+    }
+
+  private:
+    friend class Context;
+
+    // Запоминает новое наибольшее использование памяти текущим контекстом либо, если оно
+    // превышает квоту, отменяет выделение size байт и выбрасывает исключение
+    static void OnNewPeak(size_t size);
+
+    static inline thread_local std::int64_t bytes_ = 0;
+    // Выделение, после которого занятая память превышает порог, проверяется медленным путём.
+    // Без контекста порог не достигается
+    static inline thread_local std::int64_t watermark_ = std::numeric_limits<std::int64_t>::max();
+    static inline thread_local Context *context_ = nullptr;
 };
 
 // Базовый класс для всех объектов языка Mython
@@ -24,20 +107,76 @@ class Object {
     virtual ~Object() = default;
     // выводит в os своё представление в виде строки
     virtual void Print(std::ostream &os, Context &context) = 0;
+
+    // Объекты в куче учитываются в MemoryUsage. Виртуальный деструктор передаёт в
+    // operator delete размер настоящего типа объекта
+    static void *operator new(size_t size) {
+        MemoryUsage::Allocate(size);
+        try {
+            return ::operator new(size);
+        } catch (...) {
+            MemoryUsage::Release(size);
+            throw;
+        }
+    }
+    static void operator delete(void *ptr, size_t size) noexcept {
+        MemoryUsage::Release(size);
+        ::operator delete(ptr);
+    }
+
+  private:
+    friend class ObjectHolder;
+    friend class GarbageCollector;
+
+    // Количество владеющих ObjectHolder. Объекты, не созданные через ObjectHolder::Own,
+    // (например, размещённые на стеке) всегда имеют нулевой счётчик
+    mutable RefCount ref_count_;
 };
 
-// Специальный класс-обёртка, предназначенный для хранения объекта в Mython-программе
+// Учитывает создание объекта типа T в счётчиках исполнения ExecutionStats
+template <typename T>
+void CountAllocation() noexcept;
+
+// Специальный класс-обёртка, предназначенный для хранения объекта в Mython-программе.
+// Занимает одно машинное слово: указатель на объект, в младшем бите которого хранится
+// признак владения. Счётчик ссылок находится в самом объекте, поэтому ни Own, ни Share
+// не выделяют управляющих блоков
 class ObjectHolder {
   public:
     // Создаёт пустое значение
     ObjectHolder() = default;
 
+    ObjectHolder(const ObjectHolder &other) noexcept : data_(other.data_) {
+        AddRef();
+    }
+    ObjectHolder(ObjectHolder &&other) noexcept : data_(other.data_) {
+        other.data_ = 0;
+    }
+    ObjectHolder &operator=(const ObjectHolder &other) noexcept {
+        other.AddRef();
+        Release();
+        data_ = other.data_;
+        return *this;
+    }
+    ObjectHolder &operator=(ObjectHolder &&other) noexcept {
+        if (this != &other) {
+            Release();
+            data_ = other.data_;
+            other.data_ = 0;
+        }
+        return *this;
+    }
+    ~ObjectHolder() {
+        Release();
+    }
+
     // Возвращает ObjectHolder, владеющий объектом типа T
     // Тип T - конкретный класс-наследник Object.
     // object копируется или перемещается в кучу
     template <typename T>
     [[nodiscard]] static ObjectHolder Own(T &&object) {
-        return ObjectHolder(std::make_shared<T>(std::forward<T>(object)));
+        CountAllocation<std::decay_t<T>>();
+        return ObjectHolder(new std::decay_t<T>(std::forward<T>(object)), true);
     }
 
     // Создаёт ObjectHolder, не владеющий объектом (аналог слабой ссылки)
@@ -47,11 +186,19 @@ class ObjectHolder {
 
     // Возвращает ссылку на Object внутри ObjectHolder.
     // ObjectHolder должен быть непустым
-    Object &operator*() const;
+    Object &operator*() const {
+        AssertIsValid();
+        return *Get();
+    }
 
-    Object *operator->() const;
+    Object *operator->() const {
+        AssertIsValid();
+        return Get();
+    }
 
-    [[nodiscard]] Object *Get() const;
+    [[nodiscard]] Object *Get() const {
+        return reinterpret_cast<Object *>(data_ & ~OWNER_BIT); // NOLINT
+    }
 
     // Возвращает указатель на объект типа T либо nullptr, если внутри ObjectHolder не хранится
     // объект данного типа
@@ -61,13 +208,47 @@ class ObjectHolder {
     }
 
     // Возвращает true, если ObjectHolder не пуст
-    explicit operator bool() const;
+    explicit operator bool() const {
+        return data_ != 0;
+    }
+
+    // Возвращает true, если ObjectHolder - единственный владелец объекта. Объект, созданный
+    // через Own и доступный только через этот ObjectHolder, можно изменять на месте
+    [[nodiscard]] bool IsSoleOwner() const {
+        return IsOwner() && Get()->ref_count_.Get() == 1;
+    }
+
+    // Возвращает true, если ObjectHolder владеет объектом и продлевает его время жизни
+    [[nodiscard]] bool IsOwner() const {
+        return (data_ & OWNER_BIT) != 0;
+    }
 
   private:
-    explicit ObjectHolder(std::shared_ptr<Object> data);
+    friend class GarbageCollector;
+
+    static constexpr std::uintptr_t OWNER_BIT = 1;
+
+    // Если owner равен true, ObjectHolder становится одним из владельцев object
+    ObjectHolder(Object *object, bool owner) noexcept
+        : data_(reinterpret_cast<std::uintptr_t>(object) | (owner ? OWNER_BIT : 0)) { // NOLINT
+        AddRef();
+    }
+
+    void AddRef() const noexcept {
+        if (IsOwner()) {
+            ++Get()->ref_count_;
+        }
+    }
+
+    void Release() noexcept {
+        if (IsOwner() && --Get()->ref_count_ == 0) {
+            delete Get();
+        }
+    }
+
     void AssertIsValid() const;
 
-    std::shared_ptr<Object> data_;
+    std::uintptr_t data_ = 0;
 };
 
 // Объект-значение, хранящий значение типа T
@@ -75,7 +256,7 @@ template <typename T>
 class ValueObject : public Object {
   public:
     ValueObject(T v) // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
-        : value_(v) {}
+        : value_(std::move(v)) {}
 
     void Print(std::ostream &os, [[maybe_unused]] Context &context) override {
         os << value_;
@@ -85,16 +266,744 @@ class ValueObject : public Object {
         return value_;
     }
 
+    // Заменяет значение на месте. Значения Mython неизменяемы, поэтому вызывать метод можно,
+    // только если объект не виден ни через какую другую ссылку (см. ObjectHolder::IsSoleOwner)
+    void SetValue(T value) {
+        value_ = std::move(value);
+    }
+
   private:
     T value_;
 };
 
-// Таблица символов, связывающая имя объекта с его значением
-using Closure = std::unordered_map<std::string, ObjectHolder>;
+/*
+ * Фактические параметры вызова метода: непрерывная последовательность значений, которой
+ * ArgumentList не владеет. Вызывающая сторона размещает значения там, где ей удобно (на стеке,
+ * во временном списке инициализации или в векторе), поэтому передача параметров не требует
+ * выделения памяти. Значения должны существовать до завершения вызова
+ */
+class ArgumentList {
+  public:
+    ArgumentList() = default;
+    ArgumentList(const ObjectHolder *data, size_t size) : data_(data), size_(size) {}
+    template <typename Allocator>
+    ArgumentList( // NOLINT(google-explicit-constructor)
+        const std::vector<ObjectHolder, Allocator> &args)
+        : data_(args.data()), size_(args.size()) {}
+    // Массив списка инициализации существует до конца полного выражения, содержащего вызов
+    ArgumentList(std::initializer_list<ObjectHolder> args) // NOLINT(google-explicit-constructor)
+        : size_(args.size()) {
+        data_ = args.begin();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return size_;
+    }
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+    const ObjectHolder &operator[](size_t index) const {
+        return data_[index];
+    }
+    [[nodiscard]] const ObjectHolder *begin() const {
+        return data_;
+    }
+    [[nodiscard]] const ObjectHolder *end() const {
+        return data_ + size_;
+    }
+
+  private:
+    const ObjectHolder *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Список свободных блоков памяти размера Size, принадлежащий потоку. Хранит не больше
+// MAX_BLOCKS блоков, остальные возвращаются в кучу
+template <size_t Size>
+class BlockPool {
+  public:
+    static constexpr size_t MAX_BLOCKS = 1 << 16;
+    static_assert(Size >= sizeof(void *));
+
+    static void *Pop() {
+        auto &pool = Instance();
+        if (!pool.head_) {
+            return nullptr;
+        }
+        void *block = pool.head_;
+        pool.head_ = pool.head_->next;
+        --pool.size_;
+        return block;
+    }
+
+    static void Push(void *block) {
+        auto &pool = Instance();
+        if (pool.size_ == MAX_BLOCKS) {
+            ::operator delete(block);
+            return;
+        }
+        pool.head_ = new (block) FreeBlock{pool.head_};
+        ++pool.size_;
+    }
+
+    BlockPool(const BlockPool &) = delete;
+    BlockPool &operator=(const BlockPool &) = delete;
+
+    ~BlockPool() {
+        while (head_) {
+            ::operator delete(std::exchange(head_, head_->next));
+        }
+    }
+
+  private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    BlockPool() = default;
+
+    static BlockPool &Instance() {
+        thread_local BlockPool pool;
+        return pool;
+    }
+
+    FreeBlock *head_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Распределитель памяти, учитывающий выделенную память в MemoryUsage
+template <typename T>
+class TrackedAllocator {
+  public:
+    using value_type = T;
+
+    TrackedAllocator() = default;
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U> & /*other*/) noexcept {} // NOLINT
+
+    T *allocate(size_t n) {
+        MemoryUsage::Allocate(n * sizeof(T));
+        try {
+            return std::allocator<T>().allocate(n);
+        } catch (...) {
+            MemoryUsage::Release(n * sizeof(T));
+            throw;
+        }
+    }
+
+    void deallocate(T *ptr, size_t n) noexcept {
+        MemoryUsage::Release(n * sizeof(T));
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    friend bool operator==(const TrackedAllocator & /*lhs*/, const TrackedAllocator & /*rhs*/) {
+        return true;
+    }
+    friend bool operator!=(const TrackedAllocator & /*lhs*/, const TrackedAllocator & /*rhs*/) {
+        return false;
+    }
+};
+
+// Вектор значений программы, память которого учитывается в MemoryUsage
+template <typename T>
+using TrackedVector = std::vector<T, TrackedAllocator<T>>;
+
+// Распределитель памяти для контейнеров интерпретатора. Одиночные объекты (узлы хеш-таблиц)
+// после освобождения попадают в BlockPool и переиспользуются без обращения к куче.
+// Блоки выделяются по отдельности, поэтому узел можно освободить в любом потоке.
+// Выделенная память учитывается в MemoryUsage независимо от того, взята ли она из пула
+template <typename T>
+class PoolAllocator {
+  public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> & /*other*/) noexcept {} // NOLINT
+
+    T *allocate(size_t n) {
+        MemoryUsage::Allocate(n * sizeof(T));
+        if (n == 1) {
+            if (void *block = BlockPool<BlockSize()>::Pop()) {
+                return static_cast<T *>(block);
+            }
+            return static_cast<T *>(::operator new(BlockSize()));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n) noexcept {
+        MemoryUsage::Release(n * sizeof(T));
+        if (n == 1) {
+            BlockPool<BlockSize()>::Push(ptr);
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+    friend bool operator==(const PoolAllocator & /*lhs*/, const PoolAllocator & /*rhs*/) {
+        return true;
+    }
+    friend bool operator!=(const PoolAllocator & /*lhs*/, const PoolAllocator & /*rhs*/) {
+        return false;
+    }
+
+  private:
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+    static constexpr size_t BlockSize() {
+        return std::max(sizeof(T), sizeof(void *));
+    }
+};
+
+/*
+ * Таблица символов, связывающая имя объекта с его значением.
+ *
+ * Таблица может надстраиваться над замороженными слоями, которые разделяют несколько таблиц.
+ * Fork замораживает собственные переменные таблицы в новый слой и возвращает таблицу над
+ * этим слоем за O(1), после чего копирование любой из таблиц копирует только переменные,
+ * изменённые после Fork. Переменная слоя копируется в собственные переменные таблицы при
+ * первом обращении на запись (operator[], неконстантный at), чтение её не копирует.
+ * Слои неизменяемы, поэтому изменения одной таблицы не видны другим. Объекты, на которые
+ * ссылаются переменные слоя, по-прежнему общие, как и при копировании таблицы.
+ *
+ * Ссылки на собственные переменные стабильны: добавление переменных их не инвалидирует,
+ * но после Fork ссылки, полученные до него, нельзя использовать для изменения переменных
+ */
+class Closure {
+  public:
+    using Map = std::unordered_map<std::string,
+                                   ObjectHolder,
+                                   std::hash<std::string>,
+                                   std::equal_to<std::string>,
+                                   PoolAllocator<std::pair<const std::string, ObjectHolder>>>;
+    using value_type = Map::value_type;
+
+    // Число слоёв, при превышении которого Fork сливает все слои в один
+    static constexpr size_t MAX_LAYERS = 8;
+
+  private:
+    struct Layer {
+        Map bindings;
+        std::shared_ptr<const Layer> base;
+        // Количество различных имён в этом слое и под ним
+        size_t size = 0;
+        size_t depth = 1;
+    };
+
+  public:
+    // Обходит переменные таблицы: сначала собственные, затем не перекрытые ими переменные
+    // слоёв от верхнего к нижнему
+    class ConstIterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Closure::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        ConstIterator() = default;
+
+        reference operator*() const {
+            return *it_;
+        }
+        pointer operator->() const {
+            return &*it_;
+        }
+
+        ConstIterator &operator++();
+        ConstIterator operator++(int) {
+            ConstIterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        friend bool operator==(const ConstIterator &lhs, const ConstIterator &rhs) {
+            return lhs.closure_ == rhs.closure_ && (!lhs.closure_ || (lhs.layer_ == rhs.layer_ &&
+                                                                      lhs.it_ == rhs.it_));
+        }
+        friend bool operator!=(const ConstIterator &lhs, const ConstIterator &rhs) {
+            return !(lhs == rhs);
+        }
+
+      private:
+        friend class Closure;
+
+        // layer равен nullptr для собственных переменных closure
+        ConstIterator(const Closure *closure, const Layer *layer, Map::const_iterator it)
+            : closure_(closure), layer_(layer), it_(it) {}
+
+        // Переходит к первой видимой переменной, начиная с it_
+        void SkipHidden();
+
+        // nullptr у итератора end()
+        const Closure *closure_ = nullptr;
+        const Layer *layer_ = nullptr;
+        Map::const_iterator it_;
+    };
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    Closure() = default;
+    Closure(std::initializer_list<value_type> values) : bindings_(values) {}
+
+    [[nodiscard]] const_iterator begin() const;
+    [[nodiscard]] const_iterator end() const {
+        return {};
+    }
+
+    [[nodiscard]] const_iterator find(const std::string &name) const {
+        if (const auto it = bindings_.find(name); it != bindings_.end()) {
+            return {this, nullptr, it};
+        }
+        return base_ ? FindInLayers(name) : end();
+    }
+
+    [[nodiscard]] size_t count(const std::string &name) const {
+        return find(name) != end() ? 1 : 0;
+    }
+
+    // Возвращает переменную name. Если переменной нет, выбрасывает std::out_of_range
+    [[nodiscard]] const ObjectHolder &at(const std::string &name) const;
+    // То же, но переменная слоя копируется в собственные переменные
+    ObjectHolder &at(const std::string &name);
+
+    // Возвращает ссылку на переменную name, добавляя её, если её нет
+    ObjectHolder &operator[](const std::string &name) {
+        if (const auto it = bindings_.find(name); it != bindings_.end()) {
+            return it->second;
+        }
+        return Insert(name);
+    }
+
+    // Добавляет переменную name, если её ещё нет. Возвращает true, если переменная добавлена
+    bool emplace(const std::string &name, ObjectHolder value);
+
+    [[nodiscard]] size_t size() const {
+        return bindings_.size() + (base_ ? base_->size : 0) - shadowed_;
+    }
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    // Резервирует место для count собственных переменных без перехеширования
+    void reserve(size_t count) {
+        bindings_.reserve(count);
+    }
+
+    void clear() noexcept {
+        bindings_.clear();
+        base_.reset();
+        shadowed_ = 0;
+    }
+
+    void swap(Closure &other) noexcept {
+        bindings_.swap(other.bindings_);
+        base_.swap(other.base_);
+        std::swap(shadowed_, other.shadowed_);
+    }
+
+    // Возвращает таблицу с теми же переменными, разделяющую с этой таблицей все переменные.
+    // Собственные переменные этой таблицы замораживаются в новый слой
+    [[nodiscard]] Closure Fork();
+
+    // Количество собственных переменных, то есть переменных, не разделяемых с другими
+    // таблицами
+    [[nodiscard]] size_t OwnSize() const {
+        return bindings_.size();
+    }
+
+  private:
+    [[nodiscard]] const_iterator FindInLayers(const std::string &name) const;
+    // Добавляет собственную переменную name, копируя значение переменной слоя, если оно есть
+    ObjectHolder &Insert(const std::string &name);
+    // Возвращает true, если name есть в собственных переменных или слоях выше layer
+    [[nodiscard]] bool IsHidden(const std::string &name, const Layer *layer) const;
+
+    // Собственные переменные
+    Map bindings_;
+    std::shared_ptr<const Layer> base_;
+    // Количество собственных переменных, перекрывающих переменные слоёв
+    size_t shadowed_ = 0;
+};
+
+/*
+ * Стек кадров активации методов. Кадр - Closure с параметрами и локальными переменными
+ * метода. Кадры освобождаются в порядке, обратном выделению, и остаются в стеке: следующий
+ * вызов на той же глубине получает уже размеченную таблицу, а узлы очищенного кадра
+ * возвращаются в PoolAllocator. Поэтому рекурсивные вызовы не выделяют память заново.
+ *
+ * Вызов метода Mython занимает и стек потока, поэтому стек кадров знает границу стека потока
+ * и сообщает, когда до неё остаётся меньше STACK_RESERVE байт
+ */
+class FrameStack {
+  public:
+    // Возвращает стек кадров текущего потока
+    static FrameStack &Instance();
+
+    // Возвращает пустой кадр, вмещающий locals_count переменных без перехеширования
+    Closure &Push(size_t locals_count);
+    // Освобождает последний выделенный кадр
+    void Pop() noexcept;
+
+    // Количество активных кадров
+    [[nodiscard]] size_t Depth() const {
+        return depth_;
+    }
+
+    // Возвращает true, если стека потока не хватит на ещё один вызов метода
+    [[nodiscard]] bool IsStackExhausted() const noexcept {
+        return reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0)) < stack_limit_;
+    }
+
+  private:
+    // Запас стека потока на исполнение тела метода до следующего вызова и на обработку
+    // исключения
+    static constexpr size_t STACK_RESERVE = 256 * 1024;
+
+    FrameStack();
+
+    std::vector<std::unique_ptr<Closure>> frames_;
+    size_t depth_ = 0;
+    // Адрес, ниже которого стек потока считается исчерпанным. Нулевой, если границы стека
+    // неизвестны
+    std::uintptr_t stack_limit_ = 0;
+};
+
+/*
+ * Стек вызовов программы на Mython: для каждого исполняемого метода - класс объекта, метод и
+ * номер исполняемой строки. Нижняя запись без метода соответствует коду вне методов.
+ * Интерпретатор обновляет стек при каждом вызове метода и каждой инструкции, а профилировщик
+ * читает его из другого потока, поэтому поля записей атомарны. Вызовы глубже MAX_DEPTH
+ * учитываются, но не записываются
+ */
+class CallStack {
+  public:
+    static constexpr size_t MAX_DEPTH = 1024;
+
+    struct Frame {
+        const Class *cls = nullptr;
+        const Method *method = nullptr;
+        size_t line = 0;
+    };
+
+    // Возвращает стек вызовов текущего потока
+    static CallStack &Instance();
+
+    void Push(const Class &cls, const Method &method) noexcept;
+    // Заменяет метод верхней записи при хвостовом вызове
+    void Replace(const Method &method) noexcept;
+    void Pop() noexcept;
+
+    // Запоминает строку, исполняемую в верхней записи
+    void SetLine(size_t line) noexcept {
+        const size_t depth = depth_.load(std::memory_order_relaxed);
+        if (depth < MAX_DEPTH) {
+            frames_[depth].line.store(line, std::memory_order_relaxed);
+        }
+    }
+
+    // Возвращает записи стека от нижней к верхней. Может вызываться из любого потока
+    [[nodiscard]] std::vector<Frame> Snapshot() const;
+
+  private:
+    CallStack() = default;
+
+    struct AtomicFrame {
+        std::atomic<const Class *> cls{nullptr};
+        std::atomic<const Method *> method{nullptr};
+        std::atomic<size_t> line{0};
+    };
+
+    std::array<AtomicFrame, MAX_DEPTH> frames_;
+    std::atomic<size_t> depth_{0};
+};
+
+/*
+ * Состояние выхода из метода. Инструкция return не прерывает исполнение исключением, а
+ * сохраняет результат в value и устанавливает флаг active. Пока флаг установлен, составные
+ * инструкции прекращают исполнение, а тело метода забирает результат и снимает флаг.
+ *
+ * Инструкция return self.method(args), исполняемая непосредственно в кадре текущего метода,
+ * вместо вызова сохраняет объект, имя метода и вычисленные параметры в tail_self,
+ * tail_method и tail_args.
+ * ClassInstance::Call выполняет такой хвостовой вызов в том же кадре, не увеличивая глубину
+ * стека
+ */
+struct ReturnState {
+    bool active = false;
+    ObjectHolder value;
+
+    // Кадр метода, исполняемого в данный момент
+    const Closure *frame = nullptr;
+
+    ClassInstance *tail_self = nullptr;
+    const std::string *tail_method = nullptr;
+    TrackedVector<ObjectHolder> tail_args;
+};
+
+/*
+ * Счётчики работы, выполненной программой: исполненные узлы синтаксического дерева по видам,
+ * вызовы методов, созданные объекты по типам, переменные, добавленные в Closure, и ошибки
+ * исполнения. В отличие от времени исполнения счётчики не зависят от загрузки машины и
+ * совпадают при каждом запуске программы.
+ * Счётчики ведутся только при сборке с MYTHON_STATS, иначе методы Count* пусты
+ */
+struct ExecutionStats {
+#ifdef MYTHON_STATS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    enum class NodeType : std::uint8_t {
+        Constant,
+        None,
+        VariableValue,
+        Assignment,
+        FieldAssignment,
+        IndexAssignment,
+        Print,
+        MethodCall,
+        NewInstance,
+        ListLiteral,
+        DictLiteral,
+        Index,
+        Slice,
+        Stringify,
+        Length,
+        Add,
+        Sub,
+        Mult,
+        Div,
+        Or,
+        And,
+        Not,
+        Comparison,
+        Compound,
+        MethodBody,
+        Return,
+        ClassDefinition,
+        IfElse,
+        While,
+        ForRange,
+        ForEach,
+        Import,
+        COUNT
+    };
+
+    enum class ObjectType : std::uint8_t {
+        Number,
+        BigNumber,
+        String,
+        Bool,
+        List,
+        Dict,
+        Class,
+        ClassInstance,
+        Other,
+        COUNT
+    };
+
+    static std::string_view GetName(NodeType type);
+    static std::string_view GetName(ObjectType type);
+
+    // Возвращает счётчики последнего созданного в текущем потоке контекста. В них
+    // учитываются события, которые происходят без доступа к контексту: создание объектов и
+    // ошибки исполнения
+    static ExecutionStats *Current() noexcept {
+        return current_;
+    }
+
+    void CountNode([[maybe_unused]] NodeType type) noexcept {
+#ifdef MYTHON_STATS
+        ++nodes[static_cast<size_t>(type)];
+#endif
+    }
+    void CountMethodCall() noexcept {
+#ifdef MYTHON_STATS
+        ++method_calls;
+#endif
+    }
+    void CountAllocation([[maybe_unused]] ObjectType type) noexcept {
+#ifdef MYTHON_STATS
+        ++allocations[static_cast<size_t>(type)];
+#endif
+    }
+    void CountClosureInsertion() noexcept {
+#ifdef MYTHON_STATS
+        ++closure_insertions;
+#endif
+    }
+    void CountException() noexcept {
+#ifdef MYTHON_STATS
+        ++exceptions;
+#endif
+    }
+
+    std::array<std::uint64_t, static_cast<size_t>(NodeType::COUNT)> nodes{};
+    std::uint64_t method_calls = 0;
+    std::array<std::uint64_t, static_cast<size_t>(ObjectType::COUNT)> allocations{};
+    std::uint64_t closure_insertions = 0;
+    std::uint64_t exceptions = 0;
+
+  private:
+    friend class Context;
+
+    static inline thread_local ExecutionStats *current_ = nullptr;
+};
+
+/*
+ * Ограничения исполнения программы. Шаг исполнения - вход в метод (в том числе хвостовой
+ * вызов) и каждая итерация цикла, поэтому зациклившаяся программа выполняет неограниченное
+ * число шагов. Нулевые max_steps, max_call_depth, max_memory и пустой deadline снимают
+ * соответствующее ограничение
+ */
+struct ExecutionLimits {
+    // Количество шагов исполнения
+    std::uint64_t max_steps = 0;
+    // Момент, к которому программа должна завершиться
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    // Наибольшая глубина вложенных вызовов методов. Хвостовые вызовы глубину не увеличивают.
+    // Независимо от этого ограничения вызов, которому не хватает стека потока, завершается
+    // ошибкой CallDepth (см. FrameStack::IsStackExhausted)
+    size_t max_call_depth = 0;
+    // Квота памяти в байтах, учитываемой MemoryUsage. Нулевое значение снимает ограничение
+    std::uint64_t max_memory = 0;
+};
+
+// Контекст исполнения инструкций Mython
+class Context {
+  public:
+    Context(const Context &) = delete;
+    Context &operator=(const Context &) = delete;
+
+    // Возвращает поток вывода для команд print
+    virtual std::ostream &GetOutputStream() = 0;
+
+    // Возвращает состояние выхода из исполняемого метода
+    ReturnState &GetReturnState() {
+        return return_state_;
+    }
+
+    // Возвращает контекст, созданный в текущем потоке последним, либо nullptr
+    [[nodiscard]] static Context *Current() noexcept {
+        return MemoryUsage::context_;
+    }
+
+    // Возвращает счётчики работы, выполненной в этом контексте
+    ExecutionStats &GetStats() {
+        return stats_;
+    }
+
+    // Устанавливает ограничения исполнения и обнуляет счётчик шагов
+    void SetLimits(const ExecutionLimits &limits);
+
+    [[nodiscard]] const ExecutionLimits &GetLimits() const {
+        return limits_;
+    }
+
+    // Количество шагов, выполненных после установки ограничений
+    [[nodiscard]] std::uint64_t GetSteps() const {
+        return steps_;
+    }
+
+    // Память, выделенная и не освобождённая после создания контекста
+    [[nodiscard]] std::int64_t GetMemoryUsage() const noexcept {
+        return MemoryUsage::Current() - memory_baseline_;
+    }
+    // Наибольшее значение GetMemoryUsage, в том числе во вложенных контекстах
+    [[nodiscard]] std::int64_t GetPeakMemoryUsage() const noexcept {
+        return peak_memory_;
+    }
+
+    /*
+     * Учитывает шаг исполнения. Ограничения проверяются, только когда счётчик достигает
+     * следующей точки проверки, поэтому в остальных шагах проверка стоит одного сравнения.
+     * При превышении ограничения выбрасывает ExecutionLimitExceeded
+     */
+    void CountStep() {
+        if (++steps_ >= next_check_) {
+            CheckLimits();
+        }
+    }
+
+  protected:
+    // Контексты создаются и уничтожаются в порядке стека, поэтому текущими становятся
+    // счётчики и учёт памяти последнего созданного контекста
+    Context() noexcept;
+    ~Context();
+
+  private:
+    friend class MemoryUsage;
+
+    // Часы опрашиваются не чаще одного раза за столько шагов
+    static constexpr std::uint64_t DEADLINE_CHECK_INTERVAL = 1024;
+
+    void CheckLimits();
+    // Вычисляет номер шага, на котором ограничения проверяются в следующий раз
+    void ScheduleCheck() noexcept;
+
+    ReturnState return_state_;
+    ExecutionStats stats_;
+    ExecutionStats *outer_stats_;
+
+    ExecutionLimits limits_;
+    std::uint64_t steps_ = 0;
+    std::uint64_t next_check_ = std::numeric_limits<std::uint64_t>::max();
+
+    std::int64_t memory_baseline_ = 0;
+    std::int64_t peak_memory_ = 0;
+    Context *outer_context_ = nullptr;
+};
+
+// Ошибка исполнения программы на Mython. Созданные ошибки учитываются в счётчиках
+// исполнения текущего контекста
+class RuntimeError : public std::runtime_error {
+  public:
+    explicit RuntimeError(const std::string &message) : std::runtime_error(message) {
+        if (auto *stats = ExecutionStats::Current()) {
+            stats->CountException();
+        }
+    }
+};
+
+// Ошибка превышения ограничения исполнения ExecutionLimits
+class ExecutionLimitExceeded : public RuntimeError {
+  public:
+    enum class Reason : std::uint8_t { Steps, Deadline, CallDepth, Memory };
+
+    ExecutionLimitExceeded(Reason reason, const std::string &message)
+        : RuntimeError(message), reason_(reason) {}
+
+    [[nodiscard]] Reason GetReason() const noexcept {
+        return reason_;
+    }
+
+  private:
+    Reason reason_;
+};
+
+// Возвращает ссылку на переменную name в closure. Отсутствующая переменная добавляется, и
+// добавление учитывается в счётчиках контекста
+inline ObjectHolder &GetOrInsert(Closure &closure,
+                                 const std::string &name,
+                                 [[maybe_unused]] Context &context) {
+#ifdef MYTHON_STATS
+    const size_t size = closure.size();
+    ObjectHolder &variable = closure[name];
+    if (closure.size() != size) {
+        context.GetStats().CountClosureInsertion();
+    }
+    return variable;
+#else
+    return closure[name];
+#endif
+}
 
 // Проверяет, содержится ли в object значение, приводимое к True
-// Для отличных от нуля чисел, True и непустых строк возвращается true. В остальных случаях -
-// false.
+// Для отличных от нуля чисел, True, непустых строк, списков и словарей возвращается true.
+// В остальных случаях - false.
 bool IsTrue(const ObjectHolder &object);
 
 // Интерфейс для выполнения действий над объектами Mython
@@ -104,12 +1013,203 @@ class Executable {
     // Выполняет действие над объектами внутри closure, используя context
     // Возвращает результирующее значение либо None
     virtual ObjectHolder Execute(Closure &closure, Context &context) = 0;
+
+    // Номер строки программы, с которой начинается инструкция, или 0, если он неизвестен
+    [[nodiscard]] size_t GetLine() const {
+        return line_;
+    }
+    void SetLine(size_t line) {
+        line_ = line;
+    }
+
+  private:
+    size_t line_ = 0;
 };
 
-// Строковое значение
-using String = ValueObject<std::string>;
-// Числовое значение
-using Number = ValueObject<int>;
+/*
+ * Неизменяемая строка. Строки длиной до INLINE_CAPACITY символов хранятся прямо в объекте,
+ * более длинные - в буфере в куче, который разделяют все копии строки: копирование лишь
+ * увеличивает счётчик ссылок буфера. Хеш длинной строки вычисляется при первом обращении и
+ * сохраняется в буфере, поэтому сравнение разных строк обычно не доходит до символов.
+ * Строки констант программы и снимков Snapshot копируются из разных потоков, поэтому счётчик
+ * ссылок буфера атомарный при любой сборке
+ */
+class SharedString {
+  public:
+    // Символы короткой строки занимают место указателя на буфер и выравнивание за ним
+    static constexpr size_t INLINE_CAPACITY = 24;
+
+    SharedString() noexcept : inline_{} {}
+    explicit SharedString(std::string_view str);
+
+    SharedString(const SharedString &other) noexcept;
+    SharedString(SharedString &&other) noexcept;
+    SharedString &operator=(const SharedString &other) noexcept;
+    SharedString &operator=(SharedString &&other) noexcept;
+    ~SharedString();
+
+    // Возвращает строку lhs + rhs. Символы копируются в новую строку один раз
+    [[nodiscard]] static SharedString Concat(std::string_view lhs, std::string_view rhs);
+
+    // Создаёт строку длины size, символы которой записывает fill(char *data)
+    template <typename Fill>
+    [[nodiscard]] static SharedString Create(size_t size, Fill &&fill) {
+        SharedString result(size);
+        fill(result.MutableData());
+        return result;
+    }
+
+    [[nodiscard]] std::string_view View() const noexcept {
+        return IsInline() ? std::string_view(inline_, inline_size_)
+                          : std::string_view(heap_->Data(), heap_->size);
+    }
+    [[nodiscard]] size_t size() const noexcept {
+        return IsInline() ? inline_size_ : heap_->size;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // Возвращает хеш строки, совпадающий с std::hash<std::string_view>
+    [[nodiscard]] size_t Hash() const;
+
+    // Строки, разделяющие буфер, равны без сравнения символов, строки с разной длиной или
+    // разными сохранёнными хешами - не равны
+    friend bool operator==(const SharedString &lhs, const SharedString &rhs);
+    friend bool operator!=(const SharedString &lhs, const SharedString &rhs) {
+        return !(lhs == rhs);
+    }
+    friend bool operator==(const SharedString &lhs, std::string_view rhs) {
+        return lhs.View() == rhs;
+    }
+    friend bool operator==(std::string_view lhs, const SharedString &rhs) {
+        return lhs == rhs.View();
+    }
+    friend bool operator<(const SharedString &lhs, const SharedString &rhs) {
+        return lhs.View() < rhs.View();
+    }
+    friend std::ostream &operator<<(std::ostream &os, const SharedString &str) {
+        return os << str.View();
+    }
+
+  private:
+    // Заголовок буфера длинной строки, символы размещаются сразу за ним
+    struct Buffer {
+        std::atomic<size_t> refs{0};
+        size_t size = 0;
+        // 0 - хеш ещё не вычислен
+        std::atomic<size_t> hash{0};
+
+        [[nodiscard]] char *Data() noexcept {
+            return reinterpret_cast<char *>(this + 1); // NOLINT
+        }
+    };
+
+    static constexpr std::uint8_t HEAP_TAG = 0xff;
+
+    // Создаёт строку длины size с неинициализированными символами
+    explicit SharedString(size_t size);
+
+    [[nodiscard]] bool IsInline() const noexcept {
+        return inline_size_ != HEAP_TAG;
+    }
+    [[nodiscard]] char *MutableData() noexcept {
+        return IsInline() ? inline_ : heap_->Data();
+    }
+    void Release() noexcept;
+
+    union {
+        char inline_[INLINE_CAPACITY];
+        Buffer *heap_;
+    };
+    // Длина строки, хранящейся в объекте, либо HEAP_TAG
+    std::uint8_t inline_size_ = 0;
+};
+
+/*
+ * Строковое значение.
+ * Конкатенация длинных строк не копирует символы, а создаёт узел дерева (rope), ссылающийся
+ * на строки-операнды. Дерево приводится к плоской строке только при обращении к значению:
+ * выводе, сравнении или вычислении хеша. Поэтому построение строки из n частей в цикле
+ * s = s + piece занимает O(n log n), а не O(n^2).
+ * Дерево балансируется как AVL-дерево, короткие соседние части склеиваются в одну, а строка
+ * глубже MAX_ROPE_DEPTH сразу приводится к плоскому виду.
+ * Приведение к плоскому виду изменяет объект и не синхронизировано между потоками
+ */
+class String : public Object {
+  public:
+    // Части короче LEAF_SIZE символов склеиваются сразу
+    static constexpr size_t LEAF_SIZE = 256;
+    static constexpr unsigned MAX_ROPE_DEPTH = 64;
+
+    String(std::string_view value) // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        : value_(value), size_(value.size()) {}
+    String(const std::string &value) // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        : value_(value), size_(value.size()) {}
+    String(const char *value) // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        : String(std::string_view(value)) {}
+    explicit String(SharedString value) : value_(std::move(value)), size_(value_.size()) {}
+
+    // Возвращает строку lhs + rhs. lhs и rhs должны содержать объекты String
+    [[nodiscard]] static ObjectHolder Concat(const ObjectHolder &lhs, const ObjectHolder &rhs);
+
+    void Print(std::ostream &os, [[maybe_unused]] Context &context) override {
+        os << GetValue().View();
+    }
+
+    // Возвращает значение строки, при необходимости приводя её к плоскому виду
+    [[nodiscard]] const SharedString &GetValue() const {
+        if (left_) {
+            Flatten();
+        }
+        return value_;
+    }
+
+    // Возвращает длину строки, не приводя её к плоскому виду
+    [[nodiscard]] size_t Size() const {
+        return size_;
+    }
+
+  private:
+    // Узел дерева из двух строк. Строка, глубина которой превысила бы MAX_ROPE_DEPTH,
+    // сразу приводится к плоскому виду
+    String(ObjectHolder left, ObjectHolder right);
+
+    [[nodiscard]] static ObjectHolder Join(const ObjectHolder &lhs, const ObjectHolder &rhs);
+    [[nodiscard]] static ObjectHolder MakeBalanced(const ObjectHolder &lhs,
+                                                   const ObjectHolder &rhs);
+    [[nodiscard]] static const String &Of(const ObjectHolder &holder) {
+        return static_cast<const String &>(*holder);
+    }
+
+    void Flatten() const;
+    // Копирует символы строки в out и возвращает указатель на следующий за ними символ
+    char *CopyTo(char *out) const;
+
+    // Значение плоской строки
+    mutable SharedString value_;
+    // Части строки-узла дерева. После приведения к плоскому виду освобождаются
+    mutable ObjectHolder left_, right_;
+    size_t size_ = 0;
+    // Высота дерева: 0 у плоской строки
+    mutable unsigned depth_ = 0;
+};
+
+// Числовое значение. Результат арифметики, не умещающийся в 64 бита, становится BigNumber
+using Number = ValueObject<std::int64_t>;
+
+// Целое число, не умещающееся в Number. Число, которое умещается в Number, всегда
+// представляется объектом Number, поэтому Number и BigNumber никогда не равны
+using BigNumber = ValueObject<BigInt>;
+
+// Возвращает true, если object содержит целое число: Number или BigNumber
+bool IsInteger(const ObjectHolder &object);
+
+// Возвращает значение целого числа object (Number или BigNumber)
+BigInt ToBigInt(const ObjectHolder &object);
+
+// Возвращает Number, если value умещается в 64 бита, и BigNumber в противном случае
+ObjectHolder MakeInteger(BigInt value);
 
 // Логическое значение
 class Bool : public ValueObject<bool> {
@@ -119,6 +1219,211 @@ class Bool : public ValueObject<bool> {
     void Print(std::ostream &os, Context &context) override;
 };
 
+/*
+ * Список - изменяемая последовательность значений. Элементы хранятся в непрерывном массиве
+ * ObjectHolder, поэтому элемент занимает одно машинное слово, доступ по индексу выполняется
+ * за O(1), а добавление в конец - за амортизированное O(1).
+ *
+ * Сборщик мусора не заглядывает внутрь списков: экземпляры классов, хранящиеся в списках,
+ * считаются достижимыми, а циклические ссылки через списки не освобождаются
+ */
+class List : public Object {
+  public:
+    List() = default;
+    explicit List(TrackedVector<ObjectHolder> items) : items_(std::move(items)) {}
+
+    // Выводит элементы через запятую в квадратных скобках, например "[1, abc, None]".
+    // Список, содержащий сам себя, выводится как "[...]"
+    void Print(std::ostream &os, Context &context) override;
+
+    [[nodiscard]] size_t Size() const {
+        return items_.size();
+    }
+
+    // Возвращает элемент с индексом index. Отрицательный индекс отсчитывается от конца
+    // списка. Если индекс выходит за границы списка, выбрасывает runtime_error
+    ObjectHolder &At(long long index);
+
+    // Добавляет value в конец списка
+    void Append(ObjectHolder value) {
+        items_.push_back(std::move(value));
+    }
+
+    // Возвращает новый список из элементов с индексами от start до stop, не включая stop.
+    // Отсутствующие границы означают начало и конец списка, отрицательные отсчитываются от
+    // конца, выходящие за пределы списка - ограничиваются его размером
+    [[nodiscard]] List Slice(std::optional<long long> start, std::optional<long long> stop) const;
+
+    // Возвращает true, если у списка есть метод method, принимающий argument_count параметров
+    [[nodiscard]] static bool HasMethod(const std::string &method, size_t argument_count);
+
+    // Вызывает встроенный метод списка. Поддерживается метод append(value).
+    // Для остальных методов выбрасывает runtime_error
+    ObjectHolder Call(const std::string &method, ArgumentList actual_args, Context &context);
+
+    [[nodiscard]] const TrackedVector<ObjectHolder> &Items() const {
+        return items_;
+    }
+    [[nodiscard]] TrackedVector<ObjectHolder> &Items() {
+        return items_;
+    }
+
+  private:
+    TrackedVector<ObjectHolder> items_;
+    // Устанавливается на время вывода списка, чтобы не зациклиться на ссылке на себя
+    bool printing_ = false;
+};
+
+// Возвращает хеш ключа словаря. Ключами могут быть числа, строки, значения Bool и None.
+// Ключи, равные с точки зрения Equal, имеют одинаковый хеш. Для остальных значений
+// выбрасывает runtime_error
+std::uint64_t HashKey(const ObjectHolder &key);
+
+/*
+ * Словарь - изменяемое отображение ключей в значения. Ключи сравниваются так же, как в
+ * Equal, и перебираются в порядке добавления.
+ *
+ * Пары хранятся в плотном массиве entries_ в порядке добавления, а поиск выполняется по
+ * хеш-таблице с открытой адресацией, устроенной как Swiss table: на каждую ячейку таблицы
+ * приходится управляющий байт с семью битами хеша, и при поиске сравниваются сразу
+ * GROUP_WIDTH управляющих байт, уложенных в одно машинное слово. К парам, как и к самим
+ * ключам, обращение происходит только при совпадении этих семи бит, поэтому поиск почти не
+ * выходит за пределы одной кеш-линии управляющих байт.
+ *
+ * Удаление ключей не поддерживается. Сборщик мусора не заглядывает внутрь словарей, как и
+ * внутрь списков
+ */
+class Dict : public Object {
+  public:
+    // Пара ключ-значение. Хеш ключа сохраняется, чтобы не вычислять его при росте таблицы
+    struct Entry {
+        ObjectHolder key;
+        ObjectHolder value;
+        std::uint64_t hash = 0;
+    };
+
+    Dict() = default;
+
+    // Выводит пары в порядке добавления, например "{1: one, abc: None}".
+    // Словарь, содержащий сам себя, выводится как "{...}"
+    void Print(std::ostream &os, Context &context) override;
+
+    [[nodiscard]] size_t Size() const {
+        return entries_.size();
+    }
+
+    // Возвращает указатель на значение по ключу key либо nullptr, если ключа нет в словаре.
+    // Если key не может быть ключом словаря, выбрасывает runtime_error
+    [[nodiscard]] ObjectHolder *Find(const ObjectHolder &key);
+    [[nodiscard]] const ObjectHolder *Find(const ObjectHolder &key) const;
+
+    // Возвращает значение по ключу key. Если ключа нет в словаре, выбрасывает runtime_error
+    ObjectHolder &At(const ObjectHolder &key);
+
+    // Связывает key со значением value, добавляя ключ, если его ещё нет в словаре.
+    // Возвращает ссылку на значение в словаре
+    ObjectHolder &Set(const ObjectHolder &key, ObjectHolder value);
+
+    // Резервирует место для count пар без перестроения таблицы
+    void Reserve(size_t count);
+
+    // Пары словаря в порядке добавления
+    [[nodiscard]] const TrackedVector<Entry> &Items() const {
+        return entries_;
+    }
+
+    // Забирает пары словаря, оставляя словарь пустым
+    [[nodiscard]] TrackedVector<Entry> TakeItems();
+
+  private:
+    static constexpr size_t GROUP_WIDTH = 8;
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    // Возвращает индекс пары с ключом key либо NOT_FOUND
+    [[nodiscard]] size_t FindIndex(const ObjectHolder &key, std::uint64_t hash) const;
+    // Размещает в таблице индекс пары entry_index
+    void InsertIndex(std::uint32_t entry_index, std::uint64_t hash);
+    // Перестраивает таблицу под capacity ячеек
+    void Rehash(size_t capacity);
+
+    TrackedVector<Entry> entries_;
+    // Управляющие байты: EMPTY для свободной ячейки, младшие 7 бит хеша для занятой
+    TrackedVector<std::uint8_t> control_;
+    // Индексы пар в entries_, соответствующие занятым ячейкам
+    TrackedVector<std::uint32_t> slots_;
+    // Устанавливается на время вывода словаря, чтобы не зациклиться на ссылке на себя
+    bool printing_ = false;
+};
+
+/*
+ * Кэш результатов метода, помеченного декоратором @pure. Ключ - значения фактических
+ * параметров. Кэшируются только вызовы, все параметры которых могут быть ключами словаря
+ * (числа, строки, логические значения и None), и только неизменяемые результаты.
+ * Кэш хранит не больше capacity результатов и вытесняет те, что дольше всего не
+ * использовались. Кэш не синхронизирован между потоками: класс, доступный нескольким потокам,
+ * замораживает кэши своих методов, после чего кэш не изменяется и ничего не находит
+ */
+class CallCache {
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    struct Stats {
+        // Вызовы, результат которых взят из кэша
+        std::uint64_t hits = 0;
+        // Вызовы, результата которых в кэше не оказалось
+        std::uint64_t misses = 0;
+        // Результаты, вытесненные из заполненного кэша
+        std::uint64_t evictions = 0;
+        // Вызовы с параметрами, которые не могут быть ключом кэша
+        std::uint64_t uncacheable = 0;
+    };
+
+    explicit CallCache(size_t capacity = DEFAULT_CAPACITY);
+
+    // Возвращает результат, сохранённый для параметров args, или nullptr.
+    // Указатель действителен до следующего изменения кэша
+    [[nodiscard]] const ObjectHolder *Find(ArgumentList args);
+
+    // Сохраняет результат вызова с параметрами args, если такой вызов можно кэшировать
+    void Insert(ArgumentList args, const ObjectHolder &result);
+
+    [[nodiscard]] size_t Size() const {
+        return entries_.size();
+    }
+
+    [[nodiscard]] const Stats &GetStats() const {
+        return stats_;
+    }
+
+    // Отключает кэш: Find больше ничего не находит, а Insert ничего не сохраняет
+    void Freeze() noexcept {
+        frozen_ = true;
+    }
+    [[nodiscard]] bool IsFrozen() const noexcept {
+        return frozen_;
+    }
+
+  private:
+    struct Entry {
+        TrackedVector<ObjectHolder> args;
+        ObjectHolder result;
+        std::uint64_t hash;
+    };
+    using EntryList = std::list<Entry>;
+
+    // Возвращает хеш параметров или nullopt, если параметры не могут быть ключом кэша
+    [[nodiscard]] static std::optional<std::uint64_t> HashArgs(ArgumentList args);
+    // Возвращает запись с параметрами args или entries_.end()
+    [[nodiscard]] EntryList::iterator FindEntry(ArgumentList args, std::uint64_t hash);
+
+    // Записи в порядке использования: недавно использованные в начале
+    EntryList entries_;
+    std::unordered_multimap<std::uint64_t, EntryList::iterator> index_;
+    size_t capacity_;
+    Stats stats_;
+    bool frozen_ = false;
+};
+
 // Метод класса
 struct Method {
     // Имя метода
@@ -127,6 +1432,13 @@ struct Method {
     std::vector<std::string> formal_params;
     // Тело метода
     std::unique_ptr<Executable> body;
+    // Количество имён в кадре метода (self, параметры и локальные переменные),
+    // используется, чтобы заранее разметить кадр. 0 - неизвестно
+    size_t locals_count = 0;
+    // Кэш результатов метода, помеченного как чистый (@pure): результат такого метода
+    // зависит только от параметров, а не от полей self, и метод не имеет побочных эффектов.
+    // nullptr для обычных методов
+    std::unique_ptr<CallCache> cache = nullptr;
 };
 
 // Класс
@@ -134,17 +1446,34 @@ class Class : public Object {
   public:
     // Создаёт класс с именем name и набором методов methods, унаследованный от класса parent
     // Если parent равен nullptr, то создаётся базовый класс
-    explicit Class(std::string name, std::vector<Method> methods, const Class *parent)
-        : name_(std::move(name)), methods_(std::move(methods)), parent_(parent) {}
+    explicit Class(std::string name, std::vector<Method> methods, const Class *parent);
 
-    // Возвращает указатель на метод name или nullptr, если метод с таким именем отсутствует
+    // Возвращает указатель на метод name, объявленный в классе или ближайшем из его предков,
+    // или nullptr, если метод с таким именем отсутствует
     [[nodiscard]] const Method *GetMethod(const std::string &name) const;
 
+    // Возвращает метод __str__ без параметров или nullptr, если класс его не определяет.
+    // Поиск выполняется один раз при создании класса: после этого класс не меняется,
+    // поэтому результат можно читать из любого потока
+    [[nodiscard]] const Method *GetStrMethod() const {
+        return str_method_;
+    }
+
     // Возвращает имя класса
     [[nodiscard]] const std::string &GetName() const {
         return name_;
     }
 
+    // Возвращает методы, объявленные в самом классе
+    [[nodiscard]] const std::vector<Method> &GetMethods() const {
+        return methods_;
+    }
+
+    // Возвращает родительский класс или nullptr для базового класса
+    [[nodiscard]] const Class *GetParent() const {
+        return parent_;
+    }
+
     // Выводит в os строку "Class <имя класса>", например "Class cat"
     void Print(std::ostream &os, Context &context) override;
 
@@ -152,12 +1481,16 @@ class Class : public Object {
     std::string name_;
     std::vector<Method> methods_;
     const Class *parent_;
+    const Method *str_method_ = nullptr;
 };
 
 // Экземпляр класса
 class ClassInstance : public Object {
   public:
-    explicit ClassInstance(const Class &cls) : class_(cls) {}
+    explicit ClassInstance(const Class &cls);
+    ClassInstance(const ClassInstance &other);
+    ClassInstance(ClassInstance &&other) noexcept;
+    ~ClassInstance() override;
 
     /*
      * Если у объекта есть метод __str__, выводит в os результат, возвращённый этим методом.
@@ -171,13 +1504,21 @@ class ClassInstance : public Object {
      * Если ни сам класс, ни его родители не содержат метод method, метод выбрасывает
      * исключение runtime_error
      */
-    ObjectHolder Call(const std::string &method,
-                      const std::vector<ObjectHolder> &actual_args,
-                      Context &context);
+    ObjectHolder Call(const std::string &method, ArgumentList actual_args, Context &context);
+
+    // Вызывает уже найденный метод класса объекта. Число actual_args должно совпадать с
+    // числом параметров метода. Результат чистого метода берётся из его кэша, если вызов
+    // с такими параметрами уже выполнялся
+    ObjectHolder Call(const Method &method, ArgumentList actual_args, Context &context);
 
     // Возвращает true, если объект имеет метод method, принимающий argument_count параметров
     [[nodiscard]] bool HasMethod(const std::string &method, size_t argument_count) const;
 
+    // Возвращает класс, экземпляром которого является объект
+    [[nodiscard]] const Class &GetClass() const {
+        return class_;
+    }
+
     // Возвращает ссылку на Closure, содержащий поля объекта
     [[nodiscard]] Closure &Fields() {
         return closure_;
@@ -188,12 +1529,112 @@ class ClassInstance : public Object {
     }
 
   private:
+    friend class GarbageCollector;
+
+    // Выполняет метод в новом кадре, не обращаясь к кэшу. Вход в метод и каждый хвостовой
+    // вызов - шаги исполнения контекста
+    ObjectHolder Invoke(const Method &method, ArgumentList actual_args, Context &context);
+
     const Class &class_;
     Closure closure_;
+
+    // Служебные поля сборщика мусора: интрузивный список отслеживаемых экземпляров и
+    // счётчик ссылок, используемый во время сборки
+    GarbageCollector *collector_ = nullptr;
+    ClassInstance *gc_prev_ = nullptr;
+    ClassInstance *gc_next_ = nullptr;
+    long gc_refs_ = 0;
+};
+
+// Статистика работы сборщика мусора
+struct GcStats {
+    // Количество выполненных сборок
+    size_t collections = 0;
+    // Количество отслеживаемых в данный момент экземпляров классов
+    size_t tracked = 0;
+    // Количество экземпляров, освобождённых сборщиком за всё время работы
+    size_t freed = 0;
+    // Длительность пауз на сборку: суммарная, максимальная и последней сборки
+    std::chrono::nanoseconds total_pause{};
+    std::chrono::nanoseconds max_pause{};
+    std::chrono::nanoseconds last_pause{};
 };
 
 /*
- * Возвращает true, если lhs и rhs содержат одинаковые числа, строки или значения типа Bool.
+ * Сборщик циклических ссылок между экземплярами классов (mark-sweep без перемещения объектов).
+ * Подсчёт ссылок освобождает объекты сразу, но не справляется с циклами вида a.b = b; b.a = a.
+ * Сборщик находит такие циклы, когда они становятся недостижимыми, и разрывает их, очищая поля
+ * недостижимых экземпляров.
+ *
+ * Корнями считаются экземпляры, на которые ссылаются не только поля других экземпляров:
+ * переменные в Closure (глобальные и локальные переменные методов) и временные значения на
+ * стеке интерпретатора. Они вычисляются без явного обхода стека: из числа владельцев каждого
+ * экземпляра вычитаются ссылки из полей других отслеживаемых экземпляров, и всё, что
+ * остаётся с положительным счётчиком, достижимо извне. Поэтому сборку можно запускать в любой
+ * момент исполнения программы.
+ *
+ * Сборщик принадлежит потоку: экземпляры регистрируются в сборщике потока, создавшего их,
+ * и должны уничтожаться в том же потоке.
+ */
+class GarbageCollector {
+  public:
+    // Порог по умолчанию: количество созданных экземпляров между сборками
+    static constexpr size_t DEFAULT_THRESHOLD = 10000;
+
+    // Возвращает сборщик текущего потока
+    static GarbageCollector &Instance();
+
+    // Автоматическая сборка выключена по умолчанию, явный вызов Collect работает всегда
+    void SetEnabled(bool enabled) {
+        enabled_ = enabled;
+    }
+    [[nodiscard]] bool IsEnabled() const {
+        return enabled_;
+    }
+
+    // Задаёт минимальное количество экземпляров, созданных между автоматическими сборками.
+    // Фактический порог растёт вместе с числом переживших сборку экземпляров, поэтому
+    // суммарная стоимость сборок остаётся линейной от числа созданных объектов
+    void SetThreshold(size_t threshold) {
+        threshold_ = threshold;
+    }
+
+    // Запускает сборку, если она включена и куча выросла больше порога
+    void MaybeCollect() {
+        if (enabled_ && allocated_since_collect_ >= std::max(threshold_, survivors_)) {
+            Collect();
+        }
+    }
+
+    // Выполняет сборку и возвращает количество освобождённых экземпляров
+    size_t Collect();
+
+    // Перестаёт отслеживать экземпляр, созданный в этом потоке. Применяется к экземплярам,
+    // которые читают несколько потоков: сборщик одного из них не должен их изменять
+    void Detach(ClassInstance &instance);
+
+    [[nodiscard]] const GcStats &GetStats() const {
+        return stats_;
+    }
+
+  private:
+    friend class ClassInstance;
+
+    void Track(ClassInstance *instance);
+    void Untrack(ClassInstance *instance);
+
+    ClassInstance *head_ = nullptr;
+    bool enabled_ = false;
+    size_t threshold_ = DEFAULT_THRESHOLD;
+    size_t allocated_since_collect_ = 0;
+    size_t survivors_ = 0;
+    GcStats stats_;
+};
+
+/*
+ * Возвращает true, если lhs и rhs содержат одинаковые числа, строки или значения типа Bool,
+ * для списков одинаковой длины с попарно равными элементами, а также для словарей с
+ * одинаковыми ключами и равными значениями при них.
  * Если lhs - объект с методом __eq__, функция возвращает результат вызова lhs.__eq__(rhs),
  * приведённый к типу Bool. Если lhs и rhs имеют значение None, функция возвращает true.
  * В остальных случаях функция выбрасывает исключение runtime_error.
@@ -211,6 +1652,12 @@ bool Equal(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &context);
  * Параметр context задаёт контекст для выполнения метода __lt__
  */
 bool Less(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &context);
+/*
+ * Возвращает true, если item - ключ словаря container, элемент списка container (элементы
+ * сравниваются функцией Equal) либо подстрока строки container.
+ * Для остальных значений container выбрасывает runtime_error
+ */
+bool Contains(const ObjectHolder &item, const ObjectHolder &container, Context &context);
 // Возвращает значение, противоположное Equal(lhs, rhs, context)
 bool NotEqual(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &context);
 // Возвращает значение lhs>rhs, используя функции Equal и Less
@@ -220,6 +1667,36 @@ bool LessOrEqual(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &cont
 // Возвращает значение, противоположное Less(lhs, rhs, context)
 bool GreaterOrEqual(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &context);
 
+template <typename T>
+void CountAllocation() noexcept {
+#ifdef MYTHON_STATS
+    using Type = ExecutionStats::ObjectType;
+    ExecutionStats *stats = ExecutionStats::Current();
+    if (!stats) {
+        return;
+    }
+    if constexpr (std::is_same_v<T, Number>) {
+        stats->CountAllocation(Type::Number);
+    } else if constexpr (std::is_same_v<T, BigNumber>) {
+        stats->CountAllocation(Type::BigNumber);
+    } else if constexpr (std::is_same_v<T, String>) {
+        stats->CountAllocation(Type::String);
+    } else if constexpr (std::is_same_v<T, Bool>) {
+        stats->CountAllocation(Type::Bool);
+    } else if constexpr (std::is_same_v<T, List>) {
+        stats->CountAllocation(Type::List);
+    } else if constexpr (std::is_same_v<T, Dict>) {
+        stats->CountAllocation(Type::Dict);
+    } else if constexpr (std::is_same_v<T, Class>) {
+        stats->CountAllocation(Type::Class);
+    } else if constexpr (std::is_same_v<T, ClassInstance>) {
+        stats->CountAllocation(Type::ClassInstance);
+    } else {
+        stats->CountAllocation(Type::Other);
+    }
+#endif
+}
+
 // Контекст-заглушка, применяется в тестах.
 // В этом контексте весь вывод перенаправляется в строковый поток вывода output
 struct DummyContext : Context {
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace runtime {
+
+/*
+ * Снимок глобального состояния интерпретатора после выполнения пролога: объявленных классов,
+ * созданных объектов и прочих глобальных переменных. Пролог выполняется один раз, а каждый
+ * запрос начинается с копии Fork, создание которой не требует ни разбора, ни исполнения.
+ *
+ * Снимок неизменяем, и Fork можно вызывать из нескольких потоков одновременно. Неизменяемые
+ * значения (числа, строки, логические значения) и классы не копируются: их переменные лежат
+ * в замороженном слое Closure, общем для всех копий, и ссылаются на объекты снимка, не изменяя
+ * их счётчики ссылок. Изменяемые значения (списки, словари, экземпляры классов) копируются при
+ * создании копии с сохранением общих ссылок и циклов между ними, поэтому изменения в одной
+ * копии не видны ни снимку, ни другим копиям.
+ *
+ * Чтобы объекты снимка можно было читать из разных потоков, при создании снимка строки
+ * приводятся к плоскому виду, экземпляры классов перестают отслеживаться сборщиком мусора,
+ * а кэши чистых методов классов замораживаются (см. CallCache::Freeze).
+ *
+ * Снимок должен пережить все свои копии и значения, полученные из них. Уничтожить снимок
+ * можно в любом потоке, когда его копии больше не используются
+ */
+class Snapshot {
+  public:
+    // Выполняет пролог prelude с пустыми глобальными переменными и запоминает результат.
+    // Синтаксическое дерево пролога хранится в снимке: ему принадлежат тела методов
+    Snapshot(std::unique_ptr<Executable> prelude, Context &context);
+    ~Snapshot();
+
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    // Возвращает новые глобальные переменные, равные переменным снимка
+    [[nodiscard]] Closure Fork() const;
+
+    [[nodiscard]] const Closure &GetGlobals() const {
+        return globals_;
+    }
+
+  private:
+    // Подготавливает значение value и все достижимые из него объекты к чтению из разных потоков
+    void Seal(const ObjectHolder &value, std::unordered_set<const Object *> &visited);
+    void Seal(const Class &cls, std::unordered_set<const Object *> &visited);
+
+    // Копирует значение снимка в Fork. copies - уже созданные копии изменяемых объектов
+    [[nodiscard]] static ObjectHolder ForkValue(
+        const ObjectHolder &value, std::unordered_map<const Object *, ObjectHolder> &copies);
+
+    std::unique_ptr<Executable> prelude_;
+    Closure globals_;
+    // Неизменяемые переменные снимка в замороженном слое: копия этой таблицы разделяет слой
+    Closure immutable_globals_;
+    // Переменные globals_ со списками, словарями и экземплярами классов
+    std::vector<const Closure::value_type *> mutable_globals_;
+    // Экземпляры классов, списки и словари снимка. Сборщик мусора их не отслеживает, поэтому
+    // циклы между ними разрываются в деструкторе снимка
+    std::vector<ClassInstance *> instances_;
+    std::vector<List *> lists_;
+    std::vector<Dict *> dicts_;
+};
+
+} // namespace runtime
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "runtime.h"
+#include "snapshot.h"
 
 #include <functional>
+#include <memory>
 
 namespace ast {
 
@@ -16,15 +18,21 @@ class ValueStatement : public Statement {
     explicit ValueStatement(T v) : value_(std::move(v)) {}
 
     runtime::ObjectHolder Execute(runtime::Closure & /*closure*/,
-                                  runtime::Context & /*context*/) override {
+                                  runtime::Context &context) override {
+        context.GetStats().CountNode(runtime::ExecutionStats::NodeType::Constant);
         return runtime::ObjectHolder::Share(value_);
     }
 
+    [[nodiscard]] const T &GetValue() const {
+        return value_;
+    }
+
   private:
     T value_;
 };
 
 using NumericConst = ValueStatement<runtime::Number>;
+using BigNumericConst = ValueStatement<runtime::BigNumber>;
 using StringConst = ValueStatement<runtime::String>;
 using BoolConst = ValueStatement<runtime::Bool>;
 
@@ -44,6 +52,10 @@ class VariableValue : public Statement {
     runtime::ObjectHolder Execute(runtime::Closure &closure,
                                   runtime::Context &context) override;
 
+    [[nodiscard]] const std::vector<std::string> &GetDottedIds() const {
+        return dotted_ids_;
+    }
+
   private:
     std::vector<std::string> dotted_ids_;
 };
@@ -79,11 +91,29 @@ class FieldAssignment : public Statement {
     std::unique_ptr<Statement> rv_;
 };
 
+// Присваивает элементу списка или словаря object[index] значение выражения rv
+class IndexAssignment : public Statement {
+  public:
+    IndexAssignment(std::unique_ptr<Statement> object,
+                    std::unique_ptr<Statement> index,
+                    std::unique_ptr<Statement> rv)
+        : object_(std::move(object)), index_(std::move(index)), rv_(std::move(rv)) {}
+
+    // Значение по новому ключу словаря добавляется в словарь. Если object - не список и не
+    // словарь, а индекс списка - не число либо выходит за его границы, выбрасывает runtime_error
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::unique_ptr<Statement> object_, index_, rv_;
+};
+
 // Значение None
 class None : public Statement {
   public:
     runtime::ObjectHolder Execute([[maybe_unused]] runtime::Closure &closure,
-                                  [[maybe_unused]] runtime::Context &context) override {
+                                  runtime::Context &context) override {
+        context.GetStats().CountNode(runtime::ExecutionStats::NodeType::None);
         return {};
     }
 };
@@ -117,16 +147,25 @@ class MethodCall : public Statement {
   public:
     MethodCall(std::unique_ptr<Statement> object,
                std::string method,
-               std::vector<std::unique_ptr<Statement>> args)
-        : object_(std::move(object)), method_(std::move(method)), args_(std::move(args)) {}
+               std::vector<std::unique_ptr<Statement>> args);
 
     runtime::ObjectHolder Execute(runtime::Closure &closure,
                                   runtime::Context &context) override;
 
+    // Возвращает true, если метод вызывается у self
+    [[nodiscard]] bool IsSelfCall() const {
+        return self_call_;
+    }
+
+    // Вычисляет объект и параметры вызова и сохраняет их в context как хвостовой вызов,
+    // не выполняя метод. Вызов выполнит ClassInstance::Call текущего метода
+    void ScheduleTailCall(runtime::Closure &closure, runtime::Context &context);
+
   private:
     std::unique_ptr<Statement> object_;
     std::string method_;
     std::vector<std::unique_ptr<Statement>> args_;
+    bool self_call_ = false;
 };
 
 /*
@@ -158,6 +197,65 @@ class NewInstance : public Statement {
     std::vector<std::unique_ptr<Statement>> args_;
 };
 
+// Литерал списка [item1, item2, ...]. Каждое исполнение создаёт новый список
+class ListLiteral : public Statement {
+  public:
+    explicit ListLiteral(std::vector<std::unique_ptr<Statement>> items)
+        : items_(std::move(items)) {}
+
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::vector<std::unique_ptr<Statement>> items_;
+};
+
+// Литерал словаря {key1: value1, key2: value2, ...}. Каждое исполнение создаёт новый словарь
+class DictLiteral : public Statement {
+  public:
+    using Item = std::pair<std::unique_ptr<Statement>, std::unique_ptr<Statement>>;
+
+    explicit DictLiteral(std::vector<Item> items) : items_(std::move(items)) {}
+
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::vector<Item> items_;
+};
+
+// Возвращает элемент списка либо значение словаря object[index]. Отрицательный индекс
+// списка отсчитывается от его конца
+class Index : public Statement {
+  public:
+    Index(std::unique_ptr<Statement> object, std::unique_ptr<Statement> index)
+        : object_(std::move(object)), index_(std::move(index)) {}
+
+    // Если object - не список и не словарь, индекс списка - не число либо выходит за его
+    // границы, а ключа нет в словаре, выбрасывает runtime_error
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::unique_ptr<Statement> object_, index_;
+};
+
+// Возвращает новый список object[start:stop]. start и stop могут быть равны nullptr
+class Slice : public Statement {
+  public:
+    Slice(std::unique_ptr<Statement> object,
+          std::unique_ptr<Statement> start,
+          std::unique_ptr<Statement> stop)
+        : object_(std::move(object)), start_(std::move(start)), stop_(std::move(stop)) {}
+
+    // Если object - не список, а границы - не числа, выбрасывает runtime_error
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::unique_ptr<Statement> object_, start_, stop_;
+};
+
 // Базовый класс для унарных операций
 class UnaryOperation : public Statement {
   public:
@@ -175,6 +273,14 @@ class Stringify : public UnaryOperation {
                                   runtime::Context &context) override;
 };
 
+// Операция len, возвращающая количество элементов списка или словаря либо длину строки
+class Length : public UnaryOperation {
+  public:
+    using UnaryOperation::UnaryOperation;
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+};
+
 // Родительский класс Бинарная операция с аргументами lhs и rhs
 class BinaryOperation : public Statement {
   public:
@@ -194,6 +300,7 @@ class Add : public BinaryOperation {
     // Поддерживается сложение:
     //  число + число
     //  строка + строка
+    //  список + список (результат - новый список)
     //  объект1 + объект2, если у объект1 - пользовательский класс с методом _add__(rhs)
     // В противном случае при вычислении выбрасывается runtime_error
     runtime::ObjectHolder Execute(runtime::Closure &closure,
@@ -306,16 +413,20 @@ class MethodBody : public Statement {
 // Выполняет инструкцию return с выражением statement
 class Return : public Statement {
   public:
-    explicit Return(std::unique_ptr<Statement> statement) : statement_(std::move(statement)) {}
+    explicit Return(std::unique_ptr<Statement> statement);
 
     // Останавливает выполнение текущего метода. После выполнения инструкции return метод,
     // внутри которого она была исполнена, должен вернуть результат вычисления выражения
     // statement.
+    // Если statement - вызов метода у self, вызов выполняется как хвостовой: в кадре
+    // текущего метода, без роста стека
     runtime::ObjectHolder Execute(runtime::Closure &closure,
                                   runtime::Context &context) override;
 
   private:
     std::unique_ptr<Statement> statement_;
+    // Вызов метода у self, если statement является таковым, иначе nullptr
+    MethodCall *tail_call_ = nullptr;
 };
 
 // Объявляет класс
@@ -333,6 +444,18 @@ class ClassDefinition : public Statement {
     runtime::ObjectHolder class_;
 };
 
+// Инструкция import: копирует глобальные переменные модуля в closure
+class Import : public Statement {
+  public:
+    explicit Import(std::shared_ptr<const runtime::Snapshot> module) : module_(std::move(module)) {}
+
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::shared_ptr<const runtime::Snapshot> module_;
+};
+
 // Инструкция if <condition> <if_body> else <else_body>
 class IfElse : public Statement {
   public:
@@ -350,6 +473,72 @@ class IfElse : public Statement {
     std::unique_ptr<Statement> condition_, if_body_, else_body_;
 };
 
+// Инструкция while <condition>: <body>
+class While : public Statement {
+  public:
+    While(std::unique_ptr<Statement> condition, std::unique_ptr<Statement> body)
+        : condition_(std::move(condition)), body_(std::move(body)) {}
+
+    // Исполняет body, пока значение condition приводится к True, либо до выполнения
+    // инструкции return в теле цикла. Возвращает None
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::unique_ptr<Statement> condition_, body_;
+};
+
+/*
+Инструкция for <var> in range(<start>, <stop>[, <step>]): <body>
+Связывает var с числами от start до stop (не включая stop) с шагом step и для каждого
+исполняет body. Число в var изменяется на месте, если на него нет других ссылок, поэтому
+шаг цикла не создаёт новых объектов
+*/
+class ForRange : public Statement {
+  public:
+    // Цикл с границами, известными при разборе программы. step не равен 0
+    ForRange(std::string var,
+             std::int64_t start,
+             std::int64_t stop,
+             std::int64_t step,
+             std::unique_ptr<Statement> body);
+    // Цикл с границами, вычисляемыми при каждом исполнении. step может быть nullptr (шаг 1)
+    ForRange(std::string var,
+             std::unique_ptr<Statement> start,
+             std::unique_ptr<Statement> stop,
+             std::unique_ptr<Statement> step,
+             std::unique_ptr<Statement> body);
+
+    // Если границы не являются числами или шаг равен 0, выбрасывает runtime_error
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::string var_;
+    std::int64_t start_ = 0, stop_ = 0, step_ = 1;
+    std::unique_ptr<Statement> start_expr_, stop_expr_, step_expr_;
+    std::unique_ptr<Statement> body_;
+};
+
+/*
+Инструкция for <var> in <iterable>: <body>
+Последовательно связывает var с элементами списка либо ключами словаря iterable и для каждого
+исполняет body. Элементы, добавленные во время исполнения цикла, тоже будут перебраны
+*/
+class ForEach : public Statement {
+  public:
+    ForEach(std::string var, std::unique_ptr<Statement> iterable, std::unique_ptr<Statement> body)
+        : var_(std::move(var)), iterable_(std::move(iterable)), body_(std::move(body)) {}
+
+    // Если iterable - не список и не словарь, выбрасывает runtime_error
+    runtime::ObjectHolder Execute(runtime::Closure &closure,
+                                  runtime::Context &context) override;
+
+  private:
+    std::string var_;
+    std::unique_ptr<Statement> iterable_, body_;
+};
+
 // Операция сравнения
 class Comparison : public BinaryOperation {
   public:
@@ -0,0 +1,392 @@
+#include "bigint.h"
+
+#include <ostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace runtime {
+
+namespace {
+using Limb = BigInt::Limb;
+using Limbs = std::vector<Limb>;
+
+constexpr unsigned LIMB_BITS = 32;
+// Основание, по которому число переводится в десятичную запись: 9 цифр за одно деление
+constexpr Limb DECIMAL_CHUNK = 1'000'000'000;
+constexpr int DECIMAL_CHUNK_DIGITS = 9;
+
+// Непрерывная последовательность разрядов, которой LimbSpan не владеет
+struct LimbSpan {
+    const Limb *data = nullptr;
+    size_t size = 0;
+
+    LimbSpan(const Limb *data, size_t size) : data(data), size(size) {}
+    LimbSpan(const Limbs &limbs) // NOLINT(google-explicit-constructor)
+        : data(limbs.data()), size(limbs.size()) {}
+
+    // Первые count разрядов
+    [[nodiscard]] LimbSpan Prefix(size_t count) const {
+        return {data, count};
+    }
+    // Разряды, начиная с from
+    [[nodiscard]] LimbSpan Suffix(size_t from) const {
+        return {data + from, size - from};
+    }
+    // Та же последовательность без ведущих нулей
+    [[nodiscard]] LimbSpan Trimmed() const {
+        size_t count = size;
+        while (count > 0 && data[count - 1] == 0) {
+            --count;
+        }
+        return {data, count};
+    }
+};
+
+void Trim(Limbs &limbs) {
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+}
+
+// Сравнивает модули без ведущих нулей
+int CompareMagnitudes(LimbSpan lhs, LimbSpan rhs) {
+    if (lhs.size != rhs.size) {
+        return lhs.size < rhs.size ? -1 : 1;
+    }
+    for (size_t i = lhs.size; i-- > 0;) {
+        if (lhs.data[i] != rhs.data[i]) {
+            return lhs.data[i] < rhs.data[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// Прибавляет value к acc, сдвинув его на shift разрядов. acc должен вмещать сумму
+void AddInPlace(Limbs &acc, LimbSpan value, size_t shift) {
+    std::uint64_t carry = 0;
+    for (size_t i = 0; i < value.size || carry != 0; ++i) {
+        carry += acc[shift + i];
+        if (i < value.size) {
+            carry += value.data[i];
+        }
+        acc[shift + i] = static_cast<Limb>(carry);
+        carry >>= LIMB_BITS;
+    }
+}
+
+// Вычитает value из acc. Разность не должна быть отрицательной
+void SubtractInPlace(Limbs &acc, LimbSpan value) {
+    std::uint64_t borrow = 0;
+    for (size_t i = 0; i < value.size || borrow != 0; ++i) {
+        const std::uint64_t subtrahend = (i < value.size ? value.data[i] : 0) + borrow;
+        const std::uint64_t current = acc[i];
+        acc[i] = static_cast<Limb>(current - subtrahend);
+        borrow = current < subtrahend ? 1 : 0;
+    }
+}
+
+Limbs AddMagnitudes(LimbSpan lhs, LimbSpan rhs) {
+    if (lhs.size < rhs.size) {
+        std::swap(lhs, rhs);
+    }
+    Limbs result(lhs.data, lhs.data + lhs.size);
+    result.push_back(0);
+    AddInPlace(result, rhs, 0);
+    Trim(result);
+    return result;
+}
+
+// Возвращает lhs - rhs. Модуль lhs должен быть не меньше модуля rhs
+Limbs SubtractMagnitudes(LimbSpan lhs, LimbSpan rhs) {
+    Limbs result(lhs.data, lhs.data + lhs.size);
+    SubtractInPlace(result, rhs);
+    Trim(result);
+    return result;
+}
+
+Limbs MultiplySchoolbook(LimbSpan lhs, LimbSpan rhs) {
+    Limbs result(lhs.size + rhs.size);
+    for (size_t i = 0; i < lhs.size; ++i) {
+        if (lhs.data[i] == 0) {
+            continue;
+        }
+        std::uint64_t carry = 0;
+        for (size_t j = 0; j < rhs.size; ++j) {
+            carry += static_cast<std::uint64_t>(lhs.data[i]) * rhs.data[j] + result[i + j];
+            result[i + j] = static_cast<Limb>(carry);
+            carry >>= LIMB_BITS;
+        }
+        result[i + rhs.size] = static_cast<Limb>(carry);
+    }
+    Trim(result);
+    return result;
+}
+
+Limbs Multiply(LimbSpan lhs, LimbSpan rhs) {
+    lhs = lhs.Trimmed();
+    rhs = rhs.Trimmed();
+    if (lhs.size < rhs.size) {
+        std::swap(lhs, rhs);
+    }
+    if (rhs.size < BigInt::KARATSUBA_THRESHOLD) {
+        return MultiplySchoolbook(lhs, rhs);
+    }
+
+    const size_t half = lhs.size / 2;
+    Limbs result(lhs.size + rhs.size);
+    if (rhs.size <= half) {
+        // Множители сильно различаются по длине: делится только длинный
+        AddInPlace(result, Multiply(lhs.Prefix(half), rhs), 0);
+        AddInPlace(result, Multiply(lhs.Suffix(half), rhs), half);
+        Trim(result);
+        return result;
+    }
+
+    // lhs * rhs = z2 * B^(2 * half) + z1 * B^half + z0, где
+    // z1 = (lhs0 + lhs1) * (rhs0 + rhs1) - z0 - z2
+    const LimbSpan lhs0 = lhs.Prefix(half), lhs1 = lhs.Suffix(half);
+    const LimbSpan rhs0 = rhs.Prefix(half), rhs1 = rhs.Suffix(half);
+    const Limbs z0 = Multiply(lhs0, rhs0);
+    const Limbs z2 = Multiply(lhs1, rhs1);
+    Limbs z1 = Multiply(AddMagnitudes(lhs0, lhs1), AddMagnitudes(rhs0, rhs1));
+    SubtractInPlace(z1, z0);
+    SubtractInPlace(z1, z2);
+    Trim(z1);
+
+    AddInPlace(result, z0, 0);
+    AddInPlace(result, z1, half);
+    AddInPlace(result, z2, 2 * half);
+    Trim(result);
+    return result;
+}
+
+// Делит value на один разряд divisor и возвращает остаток
+Limb DivideBySmall(Limbs &value, Limb divisor) {
+    std::uint64_t remainder = 0;
+    for (size_t i = value.size(); i-- > 0;) {
+        const std::uint64_t current = (remainder << LIMB_BITS) | value[i];
+        value[i] = static_cast<Limb>(current / divisor);
+        remainder = current % divisor;
+    }
+    Trim(value);
+    return static_cast<Limb>(remainder);
+}
+
+// Возвращает частное модулей по алгоритму D Кнута. Делитель содержит не меньше двух
+// разрядов, делимое не меньше делителя
+Limbs DivideMagnitudes(LimbSpan dividend, LimbSpan divisor) {
+    const size_t m = dividend.size;
+    const size_t n = divisor.size;
+    constexpr std::uint64_t BASE = std::uint64_t{1} << LIMB_BITS;
+
+    // Нормализация: старший разряд делителя получает установленный старший бит, тогда
+    // оценка очередной цифры частного ошибается не больше чем на 2
+    unsigned shift = 0;
+    for (Limb top = divisor.data[n - 1]; (top & 0x80000000U) == 0; top <<= 1) {
+        ++shift;
+    }
+    auto shifted = [shift](const Limb *data, size_t i) {
+        const std::uint64_t low = i > 0 ? data[i - 1] : 0;
+        return static_cast<Limb>((static_cast<std::uint64_t>(data[i]) << shift) |
+                                 (low >> (LIMB_BITS - shift)));
+    };
+    Limbs v(n), u(m + 1);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = shifted(divisor.data, i);
+    }
+    for (size_t i = 0; i < m; ++i) {
+        u[i] = shifted(dividend.data, i);
+    }
+    u[m] = static_cast<Limb>(static_cast<std::uint64_t>(dividend.data[m - 1]) >>
+                             (LIMB_BITS - shift));
+
+    Limbs quotient(m - n + 1);
+    for (size_t j = m - n + 1; j-- > 0;) {
+        const std::uint64_t numerator = (static_cast<std::uint64_t>(u[j + n]) << LIMB_BITS) | u[j + n - 1];
+        std::uint64_t qhat = numerator / v[n - 1];
+        std::uint64_t rhat = numerator % v[n - 1];
+        while (qhat >= BASE || qhat * v[n - 2] > ((rhat << LIMB_BITS) | u[j + n - 2])) {
+            --qhat;
+            rhat += v[n - 1];
+            if (rhat >= BASE) {
+                break;
+            }
+        }
+
+        // u[j..j+n] -= qhat * v
+        std::int64_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const std::uint64_t product = qhat * v[i];
+            const std::int64_t diff = static_cast<std::int64_t>(u[i + j]) - borrow -
+                                      static_cast<std::int64_t>(product & (BASE - 1));
+            u[i + j] = static_cast<Limb>(diff);
+            borrow = static_cast<std::int64_t>(product >> LIMB_BITS) - (diff >> LIMB_BITS);
+        }
+        const std::int64_t top = static_cast<std::int64_t>(u[j + n]) - borrow;
+        u[j + n] = static_cast<Limb>(top);
+
+        if (top < 0) {
+            // Цифра оказалась на единицу больше: делитель прибавляется обратно
+            --qhat;
+            std::uint64_t carry = 0;
+            for (size_t i = 0; i < n; ++i) {
+                carry += static_cast<std::uint64_t>(u[i + j]) + v[i];
+                u[i + j] = static_cast<Limb>(carry);
+                carry >>= LIMB_BITS;
+            }
+            u[j + n] = static_cast<Limb>(u[j + n] + carry);
+        }
+        quotient[j] = static_cast<Limb>(qhat);
+    }
+    Trim(quotient);
+    return quotient;
+}
+} // namespace
+
+BigInt::BigInt(std::int64_t value) : negative_(value < 0) {
+    const std::uint64_t magnitude =
+        negative_ ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+    limbs_ = {static_cast<Limb>(magnitude), static_cast<Limb>(magnitude >> LIMB_BITS)};
+    Trim(limbs_);
+}
+
+BigInt::BigInt(std::vector<Limb> limbs, bool negative) : limbs_(std::move(limbs)) {
+    Trim(limbs_);
+    negative_ = negative && !limbs_.empty();
+}
+
+BigInt BigInt::FromDecimal(std::string_view digits) {
+    Limbs limbs;
+    // Цифры добавляются группами по DECIMAL_CHUNK_DIGITS: limbs = limbs * 10^длина + группа.
+    // Первая группа короче остальных, если длина записи не кратна размеру группы
+    size_t length = digits.size() % DECIMAL_CHUNK_DIGITS;
+    if (length == 0) {
+        length = DECIMAL_CHUNK_DIGITS;
+    }
+    for (size_t pos = 0; pos < digits.size(); pos += length, length = DECIMAL_CHUNK_DIGITS) {
+        Limb group = 0;
+        Limb scale = 1;
+        for (const char digit : digits.substr(pos, length)) {
+            group = group * 10 + static_cast<Limb>(digit - '0');
+            scale *= 10;
+        }
+        std::uint64_t carry = group;
+        for (Limb &limb : limbs) {
+            const std::uint64_t value = std::uint64_t{limb} * scale + carry;
+            limb = static_cast<Limb>(value);
+            carry = value >> LIMB_BITS;
+        }
+        if (carry != 0) {
+            limbs.push_back(static_cast<Limb>(carry));
+        }
+    }
+    return {std::move(limbs), false};
+}
+
+bool BigInt::FitsInt64() const {
+    if (limbs_.size() < 2) {
+        return true;
+    }
+    if (limbs_.size() > 2) {
+        return false;
+    }
+    const std::uint64_t magnitude = (static_cast<std::uint64_t>(limbs_[1]) << LIMB_BITS) | limbs_[0];
+    constexpr std::uint64_t MAX_MAGNITUDE = std::uint64_t{1} << 63;
+    return negative_ ? magnitude <= MAX_MAGNITUDE : magnitude < MAX_MAGNITUDE;
+}
+
+std::int64_t BigInt::ToInt64() const {
+    std::uint64_t magnitude = 0;
+    for (size_t i = limbs_.size(); i-- > 0;) {
+        magnitude = (magnitude << LIMB_BITS) | limbs_[i];
+    }
+    // Модуль наименьшего числа не умещается в std::int64_t, поэтому единица вычитается заранее
+    return negative_ ? -static_cast<std::int64_t>(magnitude - 1) - 1
+                     : static_cast<std::int64_t>(magnitude);
+}
+
+std::string BigInt::ToString() const {
+    if (IsZero()) {
+        return "0"s;
+    }
+    Limbs magnitude = limbs_;
+    std::vector<Limb> chunks;
+    while (!magnitude.empty()) {
+        chunks.push_back(DivideBySmall(magnitude, DECIMAL_CHUNK));
+    }
+
+    std::string result = negative_ ? "-"s : ""s;
+    result += std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+        const std::string chunk = std::to_string(chunks[i]);
+        result.append(DECIMAL_CHUNK_DIGITS - chunk.size(), '0');
+        result += chunk;
+    }
+    return result;
+}
+
+std::uint64_t BigInt::Hash() const {
+    // FNV-1a по разрядам и знаку
+    std::uint64_t hash = 0xcbf29ce484222325ULL ^ static_cast<std::uint64_t>(negative_);
+    for (const Limb limb : limbs_) {
+        hash = (hash ^ limb) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+int BigInt::Compare(const BigInt &lhs, const BigInt &rhs) {
+    if (lhs.negative_ != rhs.negative_) {
+        return lhs.negative_ ? -1 : 1;
+    }
+    const int result = CompareMagnitudes(lhs.limbs_, rhs.limbs_);
+    return lhs.negative_ ? -result : result;
+}
+
+BigInt BigInt::operator-() const {
+    return BigInt(limbs_, !negative_);
+}
+
+BigInt operator+(const BigInt &lhs, const BigInt &rhs) {
+    if (lhs.negative_ == rhs.negative_) {
+        return BigInt(AddMagnitudes(lhs.limbs_, rhs.limbs_), lhs.negative_);
+    }
+    const int order = CompareMagnitudes(lhs.limbs_, rhs.limbs_);
+    if (order == 0) {
+        return {};
+    }
+    if (order > 0) {
+        return BigInt(SubtractMagnitudes(lhs.limbs_, rhs.limbs_), lhs.negative_);
+    }
+    return BigInt(SubtractMagnitudes(rhs.limbs_, lhs.limbs_), rhs.negative_);
+}
+
+BigInt operator-(const BigInt &lhs, const BigInt &rhs) {
+    return lhs + -rhs;
+}
+
+BigInt operator*(const BigInt &lhs, const BigInt &rhs) {
+    return BigInt(Multiply(lhs.limbs_, rhs.limbs_), lhs.negative_ != rhs.negative_);
+}
+
+BigInt operator/(const BigInt &lhs, const BigInt &rhs) {
+    if (rhs.IsZero()) {
+        throw std::runtime_error("division by zero"s);
+    }
+    if (CompareMagnitudes(lhs.limbs_, rhs.limbs_) < 0) {
+        return {};
+    }
+    const bool negative = lhs.negative_ != rhs.negative_;
+    if (rhs.limbs_.size() == 1) {
+        Limbs quotient = lhs.limbs_;
+        DivideBySmall(quotient, rhs.limbs_[0]);
+        return BigInt(std::move(quotient), negative);
+    }
+    return BigInt(DivideMagnitudes(lhs.limbs_, rhs.limbs_), negative);
+}
+
+std::ostream &operator<<(std::ostream &os, const BigInt &value) {
+    return os << value.ToString();
+}
+
+} // namespace runtime
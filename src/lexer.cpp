@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <charconv>
+#include <limits>
 #include <unordered_map>
 
 using namespace std;
@@ -20,6 +21,9 @@ bool operator==(const Token &lhs, const Token &rhs) {
     if (lhs.Is<Number>()) {
         return lhs.As<Number>().value == rhs.As<Number>().value;
     }
+    if (lhs.Is<BigNumber>()) {
+        return lhs.As<BigNumber>().value == rhs.As<BigNumber>().value;
+    }
     if (lhs.Is<String>()) {
         return lhs.As<String>().value == rhs.As<String>().value;
     }
@@ -41,6 +45,7 @@ std::ostream &operator<<(std::ostream &os, const Token &rhs) {
         return os << #type << '{' << p->value << '}';
 
     VALUED_OUTPUT(Number);
+    VALUED_OUTPUT(BigNumber);
     VALUED_OUTPUT(Id);
     VALUED_OUTPUT(String);
     VALUED_OUTPUT(Char);
@@ -55,7 +60,11 @@ std::ostream &operator<<(std::ostream &os, const Token &rhs) {
     UNVALUED_OUTPUT(Return);
     UNVALUED_OUTPUT(If);
     UNVALUED_OUTPUT(Else);
+    UNVALUED_OUTPUT(While);
+    UNVALUED_OUTPUT(For);
+    UNVALUED_OUTPUT(In);
     UNVALUED_OUTPUT(Def);
+    UNVALUED_OUTPUT(Import);
     UNVALUED_OUTPUT(Newline);
     UNVALUED_OUTPUT(Print);
     UNVALUED_OUTPUT(Indent);
@@ -85,9 +94,12 @@ std::unordered_map<std::string, Token> keywords = {
     {"and", token_type::And()},        {"True", token_type::True()},
     {"False", token_type::False()},    {"not", token_type::Not()},
     {"==", token_type::Eq()},          {"!=", token_type::NotEq()},
-    {">=", token_type::GreaterOrEq()}, {"<=", token_type::LessOrEq()}};
+    {">=", token_type::GreaterOrEq()}, {"<=", token_type::LessOrEq()},
+    {"while", token_type::While()},    {"for", token_type::For()},
+    {"in", token_type::In()},          {"import", token_type::Import()}};
 
-Lexer::Lexer(std::istream &input) : input_(input) {
+Lexer::Lexer(std::istream &input, size_t first_line)
+    : input_(input), line_(first_line), current_line_(first_line) {
     if (input_) {
         current_token_ = token_type::Newline{};
     }
@@ -96,8 +108,12 @@ Lexer::Lexer(std::istream &input) : input_(input) {
 }
 
 Token Lexer::NextToken() {
-    if (input_) {
+    if (input_ || indent_level_ < 0) {
         current_token_ = GetNextToken();
+    } else if (prev_indent_ > 0) {
+        // В конце ввода закрываются все открытые блоки
+        --prev_indent_;
+        current_token_ = token_type::Dedent{};
     } else {
         current_token_ = token_type::Eof{};
     }
@@ -108,6 +124,7 @@ Token Lexer::NextToken() {
 void Lexer::IgnoreEmptyLines() {
     while (input_.peek() == '\n') {
         input_.get();
+        ++line_;
     }
 }
 
@@ -115,6 +132,7 @@ Token Lexer::GetNextToken() {
 
     if (current_token_ == token_type::Newline{} || indent_level_) {
         IgnoreEmptyLines();
+        current_line_ = line_;
         Token indent_token = GetIndent();
         if (indent_token != token_type::None{}) {
             return indent_token;
@@ -123,6 +141,7 @@ Token Lexer::GetNextToken() {
 
     while (input_) {
         char ch = input_.peek();
+        current_line_ = line_;
 
         if (ch == ' ') {
             input_.get();
@@ -131,13 +150,16 @@ Token Lexer::GetNextToken() {
 
         if (ch == '\n') {
             input_.get();
+            ++line_;
             return token_type::Newline{};
         }
 
         if (ch == '#') {
-            input_.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            IgnoreEmptyLines();
-            if (input_.peek() != EOF && current_token_ != token_type::Newline{}) {
+            // Комментарий после лексем строки; перевод строки за ним обрабатывается как обычно
+            while (input_.peek() != '\n' && input_.peek() != EOF) {
+                input_.get();
+            }
+            if (input_.peek() == EOF && current_token_ != token_type::Newline{}) {
                 return token_type::Newline{};
             }
             continue;
@@ -178,16 +200,32 @@ Token Lexer::GetNextToken() {
 }
 
 int Lexer::GetIndentLevel() {
-    static size_t prev_indent{};
-
     size_t space_count{};
-    while (input_.peek() == ' ') {
-        input_.get();
-        space_count++;
+    while (true) {
+        space_count = 0;
+        while (input_.peek() == ' ') {
+            input_.get();
+            space_count++;
+        }
+        // Строки из одних пробелов и комментариев не меняют отступ
+        if (input_.peek() == '#') {
+            input_.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            if (!input_.eof()) {
+                ++line_;
+            }
+        } else if (input_.peek() == '\n') {
+            input_.get();
+            ++line_;
+        } else {
+            break;
+        }
+    }
+    if (input_.peek() == EOF) {
+        space_count = 0;
     }
     int now_indent = (space_count / 2u);
-    int level = now_indent - prev_indent;
-    prev_indent = now_indent;
+    int level = now_indent - prev_indent_;
+    prev_indent_ = now_indent;
 
     return level;
 }
@@ -269,9 +307,16 @@ Token Lexer::GetString() {
 }
 
 Token Lexer::GetDigit() {
-    int n;
-    input_ >> n;
-    return token_type::Number{n};
+    string digits;
+    while (std::isdigit(input_.peek())) {
+        digits += static_cast<char>(input_.get());
+    }
+    std::int64_t n = 0;
+    if (from_chars(digits.data(), digits.data() + digits.size(), n).ec == errc()) {
+        return token_type::Number{n};
+    }
+    // Разбор превращает такую лексему в BigNumber
+    return token_type::BigNumber{std::move(digits)};
 }
 
 } // namespace parse
\ No newline at end of file
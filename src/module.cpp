@@ -0,0 +1,147 @@
+#include "module.h"
+
+#include "lexer.h"
+#include "parse.h"
+
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace runtime {
+
+ModuleCache &ModuleCache::Instance() {
+    // Кэш процесса не уничтожается: снимки модулей освобождали бы память после того, как
+    // уничтожены пулы памяти главного потока
+    static auto *cache = new ModuleCache();
+    return *cache;
+}
+
+void ModuleCache::SetSearchPath(vector<fs::path> directories) {
+    const lock_guard lock(mutex_);
+    search_path_ = std::move(directories);
+}
+
+shared_ptr<const Snapshot> ModuleCache::Load(const string &name) {
+    const lock_guard lock(mutex_);
+    auto snapshot = GetCurrent(name);
+    if (!loading_.empty()) {
+        loading_.back()->imports.emplace_back(name, snapshot);
+    }
+    return snapshot;
+}
+
+size_t ModuleCache::GetLoadCount() const {
+    const lock_guard lock(mutex_);
+    return load_count_;
+}
+
+void ModuleCache::Clear() {
+    const lock_guard lock(mutex_);
+    modules_.clear();
+}
+
+fs::path ModuleCache::FindFile(const string &name) const {
+    for (const auto &directory : search_path_) {
+        fs::path path = directory / (name + string(EXTENSION));
+        if (error_code error; fs::is_regular_file(path, error)) {
+            return path;
+        }
+    }
+    throw ParseError("Module "s + name + " not found"s);
+}
+
+shared_ptr<const Snapshot> ModuleCache::GetCurrent(const string &name) {
+    if (loading_names_.count(name) != 0) {
+        throw ParseError("Circular import of module "s + name);
+    }
+    auto it = modules_.find(name);
+    if (it == modules_.end() || !IsCurrent(it->second)) {
+        it = modules_.insert_or_assign(name, LoadFile(name)).first;
+    }
+    return it->second.snapshot;
+}
+
+namespace {
+
+// Время изменения и размер файла. Для недоступного файла возвращает значение, не совпадающее
+// ни с одним настоящим
+auto ReadStamp(const fs::path &path) {
+    error_code error;
+    auto mtime = fs::last_write_time(path, error);
+    const auto size = error ? 0 : fs::file_size(path, error);
+    if (error) {
+        mtime = fs::file_time_type::min();
+    }
+    return make_pair(mtime, size);
+}
+
+} // namespace
+
+bool ModuleCache::IsCurrent(const Module &module) {
+    const auto [mtime, size] = ReadStamp(module.path);
+    if (!(module.stamp == FileStamp{mtime, size})) {
+        return false;
+    }
+    for (const auto &[name, snapshot] : module.imports) {
+        if (GetCurrent(name) != snapshot) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ModuleCache::Module ModuleCache::LoadFile(const string &name) {
+    Module module;
+    module.path = FindFile(name);
+    // Время изменения читается до файла: изменение во время чтения вызовет повторную загрузку
+    const auto [mtime, size] = ReadStamp(module.path);
+    module.stamp = {mtime, size};
+    ifstream input(module.path, ios::binary);
+    if (!input) {
+        throw ParseError("Can't read module "s + name);
+    }
+    const string source{istreambuf_iterator<char>(input), istreambuf_iterator<char>()};
+
+    loading_.push_back(&module);
+    loading_names_.insert(name);
+    struct LoadingGuard {
+        ModuleCache &cache;
+        const string &name;
+        ~LoadingGuard() {
+            cache.loading_.pop_back();
+            cache.loading_names_.erase(name);
+        }
+    } guard{*this, name};
+
+    // Сообщения об ошибках разбора и исполнения модуля начинаются с его имени. Тип исключения
+    // сохраняется
+    const auto with_name = [&name](const exception &error) {
+        return "Module "s + name + ": "s + error.what();
+    };
+    try {
+        auto program = ParseProgram(source);
+        // Модуль исполняется в контексте, в котором разбирается импортирующая программа: его
+        // шаги и память учитываются в общих с программой ограничениях
+        if (Context *importer = Context::Current()) {
+            module.snapshot = make_shared<const Snapshot>(std::move(program), *importer);
+        } else {
+            DummyContext context;
+            module.snapshot = make_shared<const Snapshot>(std::move(program), context);
+        }
+    } catch (const ParseError &error) {
+        throw ParseError(with_name(error));
+    } catch (const parse::LexerError &error) {
+        throw parse::LexerError(with_name(error));
+    } catch (const ExecutionLimitExceeded &error) {
+        throw ExecutionLimitExceeded(error.GetReason(), with_name(error));
+    } catch (const RuntimeError &error) {
+        throw RuntimeError(with_name(error));
+    }
+    ++load_count_;
+    return module;
+}
+
+} // namespace runtime
@@ -1,7 +1,20 @@
 #include "parse.h"
 #include "lexer.h"
+#include "module.h"
 #include "statement.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <mutex>
+#include <streambuf>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
 using namespace std;
 
 namespace TokenType = parse::token_type;
@@ -16,9 +29,27 @@ bool operator!=(const parse::Token &token, char c) {
     return !(token == c);
 }
 
+// Константа целого числа: Number, если value умещается в 64 бита, и BigNumber в противном случае
+unique_ptr<ast::Statement> MakeIntegerConst(runtime::BigInt value) {
+    if (value.FitsInt64()) {
+        return make_unique<ast::NumericConst>(value.ToInt64());
+    }
+    return make_unique<ast::BigNumericConst>(std::move(value));
+}
+
 class Parser {
   public:
-    explicit Parser(parse::Lexer &lexer) : lexer_(lexer) {}
+    explicit Parser(parse::Lexer &lexer, runtime::Closure declared_classes = {})
+        : lexer_(lexer), declared_classes_(std::move(declared_classes)) {}
+
+    // Объявляет классы из globals, не становясь их владельцем
+    void DeclareClasses(const runtime::Closure &globals) {
+        for (const auto &[name, value] : globals) {
+            if (auto *cls = value.TryAs<runtime::Class>()) {
+                declared_classes_.emplace(name, runtime::ObjectHolder::Share(*cls));
+            }
+        }
+    }
 
     // Program -> eps
     //          | Statement \n Program
@@ -31,6 +62,25 @@ class Parser {
         return result;
     }
 
+    // То же, что ParseProgram, но возвращает инструкции программы по отдельности
+    vector<unique_ptr<ast::Statement>> ParseStatements() {
+        vector<unique_ptr<ast::Statement>> result;
+        while (!lexer_.CurrentToken().Is<TokenType::Eof>()) {
+            result.push_back(ParseStatement());
+        }
+        return result;
+    }
+
+    // Классы, объявленные в программе и до её разбора
+    runtime::Closure &GetDeclaredClasses() {
+        return declared_classes_;
+    }
+
+    // Добавляет в statements каждую разобранную инструкцию, которой присвоен номер строки
+    void CollectNumberedStatements(vector<runtime::Executable *> &statements) {
+        numbered_statements_ = &statements;
+    }
+
   private:
     // Suite -> NEWLINE INDENT (Statement)+ DEDENT
     unique_ptr<ast::Statement> ParseSuite() // NOLINT
@@ -51,14 +101,24 @@ class Parser {
         return result;
     }
 
-    // Methods -> [def id(Params) : Suite]*
+    // Methods -> [['@' pure NEWLINE] def id(Params) : Suite]*
     vector<runtime::Method> ParseMethods() // NOLINT
     {
         vector<runtime::Method> result;
 
-        while (lexer_.CurrentToken().Is<TokenType::Def>()) {
+        while (lexer_.CurrentToken().Is<TokenType::Def>() || lexer_.CurrentToken() == '@') {
             runtime::Method m;
 
+            if (lexer_.CurrentToken() == '@') {
+                const string decorator = lexer_.ExpectNext<TokenType::Id>().value;
+                if (decorator != "pure"s) {
+                    throw ParseError("Unknown decorator @"s + decorator);
+                }
+                lexer_.ExpectNext<TokenType::Newline>();
+                lexer_.ExpectNext<TokenType::Def>();
+                m.cache = std::make_unique<runtime::CallCache>();
+            }
+
             m.name = lexer_.ExpectNext<TokenType::Id>().value;
             lexer_.ExpectNext<TokenType::Char>('(');
 
@@ -73,7 +133,13 @@ class Parser {
             lexer_.ExpectNext<TokenType::Char>(':');
             lexer_.NextToken();
 
+            // Собираем имена локальных переменных метода, чтобы заранее разметить его кадр
+            unordered_set<string> locals(m.formal_params.begin(), m.formal_params.end());
+            locals.insert("self"s);
+            method_locals_ = &locals;
             m.body = std::make_unique<ast::MethodBody>(ParseSuite()); // NOLINT
+            method_locals_ = nullptr;
+            m.locals_count = locals.size();
 
             result.push_back(std::move(m));
         }
@@ -104,23 +170,23 @@ class Parser {
         lexer_.Expect<TokenType::Char>(':');
         lexer_.ExpectNext<TokenType::Newline>();
         lexer_.ExpectNext<TokenType::Indent>();
-        lexer_.ExpectNext<TokenType::Def>();
+        if (lexer_.NextToken() != '@') {
+            lexer_.Expect<TokenType::Def>();
+        }
         vector<runtime::Method> methods = ParseMethods(); // NOLINT
 
         lexer_.Expect<TokenType::Dedent>();
         lexer_.NextToken();
 
-        auto [it, inserted] = declared_classes_.insert({
+        const bool inserted = declared_classes_.emplace(
             class_name,
-            runtime::ObjectHolder::Own(
-                runtime::Class(class_name, std::move(methods), base_class)),
-        });
+            runtime::ObjectHolder::Own(runtime::Class(class_name, std::move(methods), base_class)));
 
         if (!inserted) {
             throw ParseError("Class "s + class_name + " already exists"s);
         }
 
-        return make_unique<ast::ClassDefinition>(it->second);
+        return make_unique<ast::ClassDefinition>(declared_classes_.at(class_name));
     }
 
     vector<string> ParseDottedIds() {
@@ -134,11 +200,15 @@ class Parser {
     }
 
     //  AssgnOrCall -> DottedIds = Expr
+    //               | DottedIds ['[' Expr ']']+ = Expr
     //               | DottedIds '(' ExprList ')'
     unique_ptr<ast::Statement> ParseAssignmentOrCall() {
         lexer_.Expect<TokenType::Id>();
 
         vector<string> id_list = ParseDottedIds();
+        if (lexer_.CurrentToken() == '[') {
+            return ParseIndexAssignment(std::move(id_list));
+        }
         string last_name = id_list.back();
         id_list.pop_back();
 
@@ -146,6 +216,9 @@ class Parser {
             lexer_.NextToken();
 
             if (id_list.empty()) {
+                if (method_locals_) {
+                    method_locals_->insert(last_name);
+                }
                 return make_unique<ast::Assignment>(std::move(last_name), ParseTest());
             }
             return make_unique<ast::FieldAssignment>(ast::VariableValue{std::move(id_list)},
@@ -170,6 +243,23 @@ class Parser {
             std::move(args));
     }
 
+    // Присваивание элементу списка: все индексы, кроме последнего, вычисляют сам список
+    unique_ptr<ast::Statement> ParseIndexAssignment(vector<string> id_list) {
+        unique_ptr<ast::Statement> object = make_unique<ast::VariableValue>(std::move(id_list));
+        for (;;) {
+            lexer_.NextToken();
+            auto index = ParseTest();
+            lexer_.Expect<TokenType::Char>(']');
+            if (lexer_.NextToken() != '[') {
+                lexer_.Expect<TokenType::Char>('=');
+                lexer_.NextToken();
+                return make_unique<ast::IndexAssignment>(std::move(object), std::move(index),
+                                                         ParseTest());
+            }
+            object = make_unique<ast::Index>(std::move(object), std::move(index));
+        }
+    }
+
     // Expr -> Adder ['+'/'-' Adder]*
     unique_ptr<ast::Statement> ParseExpression() // NOLINT
     {
@@ -204,16 +294,66 @@ class Parser {
         return result;
     }
 
-    // Mult -> '(' Expr ')'
+    // Mult -> '-' Mult
+    //       | Atom ['[' Subscript ']']*
+    unique_ptr<ast::Statement> ParseMult() // NOLINT
+    {
+        if (lexer_.CurrentToken() == '-') {
+            // Отрицательная числовая константа остаётся константой
+            lexer_.NextToken();
+            if (const auto *num = lexer_.CurrentToken().TryAs<TokenType::Number>()) {
+                std::int64_t result = -num->value;
+                lexer_.NextToken();
+                return ParseSubscripts(make_unique<ast::NumericConst>(result));
+            }
+            if (const auto *num = lexer_.CurrentToken().TryAs<TokenType::BigNumber>()) {
+                auto result = MakeIntegerConst(-runtime::BigInt::FromDecimal(num->value));
+                lexer_.NextToken();
+                return ParseSubscripts(std::move(result));
+            }
+            return make_unique<ast::Mult>(ParseMult(), make_unique<ast::NumericConst>(-1));
+        }
+        return ParseSubscripts(ParseAtom());
+    }
+
+    // Subscript -> Expr
+    //            | [Expr] ':' [Expr]
+    unique_ptr<ast::Statement> ParseSubscripts(unique_ptr<ast::Statement> object) // NOLINT
+    {
+        while (lexer_.CurrentToken() == '[') {
+            lexer_.NextToken();
+
+            unique_ptr<ast::Statement> start;
+            if (lexer_.CurrentToken() != ':') {
+                start = ParseTest();
+            }
+            if (lexer_.CurrentToken() == ':') {
+                unique_ptr<ast::Statement> stop;
+                if (lexer_.NextToken() != ']') {
+                    stop = ParseTest();
+                }
+                object = make_unique<ast::Slice>(std::move(object), std::move(start),
+                                                 std::move(stop));
+            } else {
+                object = make_unique<ast::Index>(std::move(object), std::move(start));
+            }
+            lexer_.Expect<TokenType::Char>(']');
+            lexer_.NextToken();
+        }
+        return object;
+    }
+
+    // Atom -> '(' Expr ')'
+    //       | '[' [ExprList] ']'
+    //       | '{' [Expr ':' Expr [, Expr ':' Expr]*] '}'
     //       | NUMBER
-    //       | '-' Mult
     //       | STRING
     //       | NONE
     //       | TRUE
     //       | FALSE
     //       | DottedIds '(' ExprList ')'
     //       | DottedIds
-    unique_ptr<ast::Statement> ParseMult() // NOLINT
+    unique_ptr<ast::Statement> ParseAtom() // NOLINT
     {
         if (lexer_.CurrentToken() == '(') {
             lexer_.NextToken();
@@ -222,15 +362,43 @@ class Parser {
             lexer_.NextToken();
             return result;
         }
-        if (lexer_.CurrentToken() == '-') {
+        if (lexer_.CurrentToken() == '[') {
+            vector<unique_ptr<ast::Statement>> items;
+            if (lexer_.NextToken() != ']') {
+                items = ParseTestList();
+            }
+            lexer_.Expect<TokenType::Char>(']');
             lexer_.NextToken();
-            return make_unique<ast::Mult>(ParseMult(), make_unique<ast::NumericConst>(-1));
+            return make_unique<ast::ListLiteral>(std::move(items));
+        }
+        if (lexer_.CurrentToken() == '{') {
+            vector<ast::DictLiteral::Item> items;
+            if (lexer_.NextToken() != '}') {
+                for (;;) {
+                    auto key = ParseTest();
+                    lexer_.Expect<TokenType::Char>(':');
+                    lexer_.NextToken();
+                    items.emplace_back(std::move(key), ParseTest());
+                    if (lexer_.CurrentToken() != ',') {
+                        break;
+                    }
+                    lexer_.NextToken();
+                }
+            }
+            lexer_.Expect<TokenType::Char>('}');
+            lexer_.NextToken();
+            return make_unique<ast::DictLiteral>(std::move(items));
         }
         if (const auto *num = lexer_.CurrentToken().TryAs<TokenType::Number>()) {
-            int result = num->value;
+            std::int64_t result = num->value;
             lexer_.NextToken();
             return make_unique<ast::NumericConst>(result);
         }
+        if (const auto *num = lexer_.CurrentToken().TryAs<TokenType::BigNumber>()) {
+            auto result = MakeIntegerConst(runtime::BigInt::FromDecimal(num->value));
+            lexer_.NextToken();
+            return result;
+        }
         if (const auto *str = lexer_.CurrentToken().TryAs<TokenType::String>()) {
             string result = str->value;
             lexer_.NextToken();
@@ -283,6 +451,12 @@ class Parser {
                 }
                 return make_unique<ast::Stringify>(std::move(args.front()));
             }
+            if (method_name == "len"sv) {
+                if (args.size() != 1) {
+                    throw ParseError("Function len takes exactly one argument"s);
+                }
+                return make_unique<ast::Length>(std::move(args.front()));
+            }
             throw ParseError("Unknown call to "s + method_name + "()"s);
         }
         return make_unique<ast::VariableValue>(std::move(names));
@@ -324,6 +498,74 @@ class Parser {
                                         std::move(else_body));
     }
 
+    // Loop -> while LogicalExpr: Suite
+    unique_ptr<ast::Statement> ParseWhile() // NOLINT
+    {
+        lexer_.Expect<TokenType::While>();
+        lexer_.NextToken();
+
+        auto condition = ParseTest();
+
+        lexer_.Expect<TokenType::Char>(':');
+        lexer_.NextToken();
+
+        return make_unique<ast::While>(std::move(condition), ParseSuite());
+    }
+
+    // ForLoop -> for Id in range '(' Expr, Expr [, Expr] ')' : Suite
+    //          | for Id in Expr : Suite
+    unique_ptr<ast::Statement> ParseFor() // NOLINT
+    {
+        lexer_.Expect<TokenType::For>();
+        string var = lexer_.ExpectNext<TokenType::Id>().value;
+        lexer_.ExpectNext<TokenType::In>();
+        lexer_.NextToken();
+        if (method_locals_) {
+            method_locals_->insert(var);
+        }
+
+        // Имя range зарезервировано за диапазоном, любое другое выражение перебирается как список
+        const auto *range = lexer_.CurrentToken().TryAs<TokenType::Id>();
+        if (!range || range->value != "range"sv) {
+            auto iterable = ParseTest();
+            lexer_.Expect<TokenType::Char>(':');
+            lexer_.NextToken();
+            return make_unique<ast::ForEach>(std::move(var), std::move(iterable), ParseSuite());
+        }
+
+        lexer_.ExpectNext<TokenType::Char>('(');
+        lexer_.NextToken();
+
+        vector<unique_ptr<ast::Statement>> args = ParseTestList();
+        if (args.size() != 2 && args.size() != 3) {
+            throw ParseError("range() takes two or three arguments"s);
+        }
+        lexer_.Expect<TokenType::Char>(')');
+        lexer_.ExpectNext<TokenType::Char>(':');
+        lexer_.NextToken();
+
+        auto body = ParseSuite();
+
+        // Границы из числовых констант вычисляются один раз, при разборе программы
+        vector<std::int64_t> bounds;
+        for (const auto &arg : args) {
+            if (const auto *value = dynamic_cast<const ast::NumericConst *>(arg.get())) {
+                bounds.push_back(value->GetValue().GetValue());
+            }
+        }
+        if (bounds.size() == args.size()) {
+            const std::int64_t step = bounds.size() == 3 ? bounds[2] : 1;
+            if (step == 0) {
+                throw ParseError("range() step cannot be zero"s);
+            }
+            return make_unique<ast::ForRange>(std::move(var), bounds[0], bounds[1], step,
+                                              std::move(body));
+        }
+        return make_unique<ast::ForRange>(std::move(var), std::move(args[0]), std::move(args[1]),
+                                          args.size() == 3 ? std::move(args[2]) : nullptr,
+                                          std::move(body));
+    }
+
     // LogicalExpr -> AndTest [OR AndTest]
     // AndTest -> NotTest [AND NotTest]
     // NotTest -> [NOT] NotTest
@@ -358,6 +600,7 @@ class Parser {
     }
 
     // Comparison -> Expr [COMP_OP Expr]
+    //             | Expr in Expr
     unique_ptr<ast::Statement> ParseComparison() // NOLINT
     {
         auto result = ParseExpression();
@@ -394,29 +637,64 @@ class Parser {
             return make_unique<ast::Comparison>(runtime::GreaterOrEqual, std::move(result),
                                                 ParseExpression());
         }
+        if (tok.Is<TokenType::In>()) {
+            lexer_.NextToken();
+            return make_unique<ast::Comparison>(runtime::Contains, std::move(result),
+                                                ParseExpression());
+        }
         return result;
     }
 
     // Statement -> SimpleStatement Newline
     //           | class ClassDefinition
     //           | if Condition
+    //           | while Loop
+    //           | for ForLoop
+    //           | import Id Newline
     unique_ptr<ast::Statement> ParseStatement() // NOLINT
     {
+        const size_t line = lexer_.CurrentLine();
         const auto &tok = lexer_.CurrentToken();
 
+        unique_ptr<ast::Statement> result;
         if (tok.Is<TokenType::Class>()) {
             lexer_.NextToken();
-            return ParseClassDefinition(); // NOLINT
+            result = ParseClassDefinition(); // NOLINT
+        } else if (tok.Is<TokenType::If>()) {
+            result = ParseCondition();
+        } else if (tok.Is<TokenType::While>()) {
+            result = ParseWhile();
+        } else if (tok.Is<TokenType::For>()) {
+            result = ParseFor();
+        } else if (tok.Is<TokenType::Import>()) {
+            result = ParseImport();
+        } else {
+            result = ParseSimpleStatement();
+            lexer_.Expect<TokenType::Newline>();
+            lexer_.NextToken();
         }
-        if (tok.Is<TokenType::If>()) {
-            return ParseCondition();
+        result->SetLine(line);
+        if (numbered_statements_) {
+            numbered_statements_->push_back(result.get());
         }
-        auto result = ParseSimpleStatement();
-        lexer_.Expect<TokenType::Newline>();
-        lexer_.NextToken();
         return result;
     }
 
+    // Import -> import Id Newline
+    // Классы модуля объявляются так же, как классы, объявленные в программе
+    unique_ptr<ast::Statement> ParseImport() {
+        if (method_locals_) {
+            throw ParseError("Import is not allowed inside methods"s);
+        }
+        const string name = lexer_.ExpectNext<TokenType::Id>().value;
+        lexer_.ExpectNext<TokenType::Newline>();
+        lexer_.NextToken();
+
+        auto module = runtime::ModuleCache::Instance().Load(name);
+        DeclareClasses(module->GetGlobals());
+        return make_unique<ast::Import>(std::move(module));
+    }
+
     // StatementBody -> return Expression
     //               | print ExpressionList
     //               | AssignmentOrCall
@@ -440,10 +718,461 @@ class Parser {
 
     parse::Lexer &lexer_;
     runtime::Closure declared_classes_;
+    // Имена локальных переменных разбираемого метода либо nullptr вне метода
+    unordered_set<string> *method_locals_ = nullptr;
+    vector<runtime::Executable *> *numbered_statements_ = nullptr;
+};
+
+// Поток ввода, читающий символы text без копирования
+class ViewStream : private std::streambuf, public std::istream {
+  public:
+    explicit ViewStream(string_view text) : std::istream(this) {
+        char *begin = const_cast<char *>(text.data()); // NOLINT
+        setg(begin, begin, begin + text.size());
+    }
 };
 
+// Часть текста программы: строка без отступа вместе со следующими строками с отступом.
+// Определение класса составляет отдельную часть, прочие инструкции, идущие подряд, - одну часть
+struct Chunk {
+    string_view text;
+    // Номер первой строки части в программе
+    size_t first_line = 1;
+    // Имя класса, если часть - определение класса
+    string_view class_name;
+};
+
+bool IsIdChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+}
+
+// Возвращает имя класса, если строка line начинается с определения класса
+string_view GetClassName(string_view line) {
+    constexpr string_view KEYWORD = "class"sv;
+    if (line.substr(0, KEYWORD.size()) != KEYWORD || line.size() == KEYWORD.size() ||
+        line[KEYWORD.size()] != ' ') {
+        return {};
+    }
+    const size_t begin = min(line.find_first_not_of(' ', KEYWORD.size()), line.size());
+    size_t end = begin;
+    while (end < line.size() && IsIdChar(line[end])) {
+        ++end;
+    }
+    return line.substr(begin, end - begin);
+}
+
+// Вызывает on_id для каждого слова text вне строковых литералов и комментариев. quote -
+// кавычка строкового литерала, не закрытого к началу text. Возвращает кавычку литерала,
+// не закрытого к концу text, либо 0
+template <typename OnId>
+char ScanCode(string_view text, char quote, OnId on_id) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if (quote != 0) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == quote) {
+                quote = 0;
+            }
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '#') {
+            i = min(text.find('\n', i), text.size());
+        } else if (IsIdChar(c)) {
+            size_t end = i + 1;
+            while (end < text.size() && IsIdChar(text[end])) {
+                ++end;
+            }
+            on_id(text.substr(i, end - i));
+            i = end - 1;
+        }
+    }
+    return quote;
+}
+
+// Вызывает on_name для каждого слова text, которое разбор ищет среди объявленных классов:
+// имени в вызове name(...) и имени базового класса в заголовке определения класса
+template <typename OnName>
+void ScanClassReferences(string_view text, OnName on_name) {
+    ScanCode(text, 0, [&](string_view id) {
+        const size_t begin = id.data() - text.data();
+        const size_t prev = begin > 0 ? text.find_last_not_of(' ', begin - 1) : string_view::npos;
+        const size_t next = text.find_first_not_of(' ', begin + id.size());
+        const char before = prev != string_view::npos ? text[prev] : '\0';
+        const char after = next != string_view::npos ? text[next] : '\0';
+        if ((after == '(' && before != '.') || (after == ')' && before == '(')) {
+            on_name(id);
+        }
+    });
+}
+
+// То же, что ScanCode, но без поиска слов
+char SkipStrings(string_view text, char quote) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if (quote != 0) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == quote) {
+                quote = 0;
+            }
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '#') {
+            break;
+        }
+    }
+    return quote;
+}
+
+// Делит программу на части. Пустые строки, комментарии и продолжения многострочных строковых
+// литералов не начинают новой части
+vector<Chunk> SplitTopLevel(string_view source) {
+    vector<Chunk> chunks;
+    Chunk chunk{source.substr(0, 0), 1, {}};
+    bool chunk_has_statements = false;
+    char quote = 0;
+    size_t line = 1;
+    for (size_t pos = 0; pos < source.size(); ++line) {
+        const size_t end = min(source.find('\n', pos), source.size() - 1) + 1;
+        const string_view text = source.substr(pos, end - pos);
+        if (quote == 0 && text[0] != ' ' && text[0] != '\n' && text[0] != '#') {
+            const string_view class_name = GetClassName(text);
+            if (chunk_has_statements && (!class_name.empty() || !chunk.class_name.empty())) {
+                chunks.push_back(chunk);
+                chunk = {source.substr(pos, 0), line, {}};
+            }
+            chunk.class_name = class_name;
+            chunk_has_statements = true;
+        }
+        quote = SkipStrings(text, quote);
+        chunk.text = {chunk.text.data(), chunk.text.size() + text.size()};
+        pos = end;
+    }
+    if (!chunk.text.empty()) {
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+// Вызывает task(i) для каждого i от 0 до count в threads потоках, считая текущий. Если задача
+// выбросила исключение, оставшиеся задачи не начинаются, а исключение выбрасывается после
+// завершения потоков
+template <typename Task>
+void ParallelFor(size_t count, size_t threads, const Task &task) {
+    atomic<size_t> next = 0;
+    exception_ptr error;
+    mutex error_mutex;
+    const auto worker = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                const lock_guard lock(error_mutex);
+                if (!error) {
+                    error = current_exception();
+                }
+                next = count;
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t i = 1; i < min(threads, count); ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : workers) {
+        thread.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+vector<unique_ptr<ast::Statement>> ParseChunk(
+    const Chunk &chunk,
+    runtime::Closure &declared_classes,
+    vector<runtime::Executable *> *numbered_statements = nullptr) {
+    ViewStream input(chunk.text);
+    parse::Lexer lexer(input, chunk.first_line);
+    Parser parser{lexer, std::move(declared_classes)};
+    if (numbered_statements) {
+        parser.CollectNumberedStatements(*numbered_statements);
+    }
+    auto statements = parser.ParseStatements();
+    declared_classes = std::move(parser.GetDeclaredClasses());
+    return statements;
+}
+
+// Разбирает count идущих подряд определений классов в threads потоках и добавляет их в
+// declared_classes и program.
+//
+// Разбор класса видит только классы, объявленные до него, поэтому классы разбираются по
+// уровням. Класс, ссылающийся на класс, объявленный раньше (см. ScanClassReferences),
+// разбирается уровнем позже этого класса, а класс, ссылающийся на класс, объявленный позже, -
+// не позже этого класса. Классы одного уровня разбираются одновременно
+void ParseClasses(const Chunk *chunks,
+                  size_t count,
+                  size_t threads,
+                  runtime::Closure &declared_classes,
+                  ast::Compound &program) {
+    size_t bytes = 0;
+    unordered_map<string_view, size_t> indices;
+    for (size_t i = 0; i < count; ++i) {
+        bytes += chunks[i].text.size();
+        indices.emplace(chunks[i].class_name, i);
+    }
+    if (bytes < PARALLEL_PARSE_MIN_BYTES) {
+        threads = 1;
+    }
+
+    vector<vector<size_t>> references(count);
+    ParallelFor(count, threads, [&](size_t i) {
+        ScanClassReferences(chunks[i].text, [&](string_view id) {
+            if (const auto it = indices.find(id); it != indices.end() && it->second != i) {
+                references[i].push_back(it->second);
+            }
+        });
+    });
+    vector<size_t> levels(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j : references[i]) {
+            if (j < i) {
+                levels[i] = max(levels[i], levels[j] + 1);
+            }
+        }
+        for (size_t j : references[i]) {
+            if (j > i) {
+                levels[j] = max(levels[j], levels[i]);
+            }
+        }
+    }
+    vector<vector<size_t>> by_level(*max_element(levels.begin(), levels.end()) + 1);
+    for (size_t i = 0; i < count; ++i) {
+        by_level[levels[i]].push_back(i);
+    }
+
+    vector<vector<unique_ptr<ast::Statement>>> statements(count);
+    vector<runtime::ObjectHolder> classes(count);
+    for (const auto &level : by_level) {
+        // Разборы одного уровня разделяют замороженную таблицу классов и не изменяют её
+        const runtime::Closure visible_classes = declared_classes.Fork();
+        ParallelFor(level.size(), threads, [&](size_t k) {
+            const size_t i = level[k];
+            runtime::Closure chunk_classes = visible_classes;
+            statements[i] = ParseChunk(chunks[i], chunk_classes);
+            classes[i] = std::as_const(chunk_classes).at(string(chunks[i].class_name));
+        });
+        for (size_t i : level) {
+            if (!declared_classes.emplace(string(chunks[i].class_name), classes[i])) {
+                throw ParseError("Class "s + string(chunks[i].class_name) + " already exists"s);
+            }
+        }
+    }
+
+    for (auto &chunk_statements : statements) {
+        for (auto &statement : chunk_statements) {
+            program.AddStatement(std::move(statement));
+        }
+    }
+}
+
+// Инструкция верхнего уровня, общая для нескольких версий программы
+class SharedStatement : public runtime::Executable {
+  public:
+    explicit SharedStatement(shared_ptr<runtime::Executable> statement)
+        : statement_(std::move(statement)) {
+        SetLine(statement_->GetLine());
+    }
+
+    runtime::ObjectHolder Execute(runtime::Closure &closure, runtime::Context &context) override {
+        return statement_->Execute(closure, context);
+    }
+
+  private:
+    shared_ptr<runtime::Executable> statement_;
+};
+
+unique_ptr<runtime::Executable> ParseChunks(const vector<Chunk> &chunks, size_t threads) {
+    auto program = make_unique<ast::Compound>();
+    runtime::Closure declared_classes;
+    for (size_t begin = 0; begin < chunks.size();) {
+        size_t end = begin + 1;
+        if (chunks[begin].class_name.empty()) {
+            for (auto &statement : ParseChunk(chunks[begin], declared_classes)) {
+                program->AddStatement(std::move(statement));
+            }
+        } else {
+            while (end < chunks.size() && !chunks[end].class_name.empty()) {
+                ++end;
+            }
+            ParseClasses(&chunks[begin], end - begin, threads, declared_classes, *program);
+        }
+        begin = end;
+    }
+    return program;
+}
+
 } // namespace
 
 unique_ptr<runtime::Executable> ParseProgram(parse::Lexer &lexer) {
     return Parser{lexer}.ParseProgram();
-}
\ No newline at end of file
+}
+
+unique_ptr<runtime::Executable> ParseProgram(parse::Lexer &lexer,
+                                             const runtime::Closure &globals) {
+    Parser parser{lexer};
+    parser.DeclareClasses(globals);
+    return parser.ParseProgram();
+}
+
+unique_ptr<runtime::Executable> ParseProgram(string_view source, size_t threads) {
+    if (threads == 0) {
+        threads = max<size_t>(thread::hardware_concurrency(), 1);
+    }
+    if (threads > 1) {
+        try {
+            return ParseChunks(SplitTopLevel(source), threads);
+        } catch (const ParseError &) {
+            // Об ошибке сообщает последовательный разбор: он находит первую ошибку программы
+            // так же, как ParseProgram(lexer). Прочие исключения (например, ошибки исполнения
+            // импортируемого модуля) передаются вызывающему без повторного разбора
+        } catch (const parse::LexerError &) {
+        }
+    }
+    ViewStream input(source);
+    parse::Lexer lexer(input);
+    return ParseProgram(lexer);
+}
+
+struct IncrementalParser::ParsedChunk {
+    string text;
+    size_t hash = 0;
+    size_t first_line = 1;
+    string class_name;
+    // Имена, которые разбор части искал среди объявленных классов (см. ScanClassReferences),
+    // и найденные классы либо nullptr
+    vector<pair<string, const runtime::Object *>> references;
+    bool has_import = false;
+    vector<shared_ptr<runtime::Executable>> statements;
+    // Инструкции части, включая тела методов, с номерами строк
+    vector<runtime::Executable *> numbered_statements;
+    // Класс, объявленный частью
+    runtime::ObjectHolder cls;
+
+    // Переносит часть на строку line, сдвигая номера строк её инструкций
+    void MoveTo(size_t line) {
+        for (runtime::Executable *statement : numbered_statements) {
+            statement->SetLine(statement->GetLine() - first_line + line);
+        }
+        first_line = line;
+    }
+};
+
+IncrementalParser::IncrementalParser() = default;
+IncrementalParser::~IncrementalParser() = default;
+
+unique_ptr<runtime::Executable> IncrementalParser::Parse(string_view source) {
+    // Части прежней версии, упорядоченные по хешу текста. Часть, взятая в новую версию,
+    // больше не предлагается, чтобы одинаковые части разных мест программы не разделяли одни
+    // инструкции
+    vector<pair<size_t, size_t>> previous;
+    previous.reserve(chunks_.size());
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        previous.emplace_back(chunks_[i]->hash, i);
+    }
+    sort(previous.begin(), previous.end());
+    vector<bool> taken(chunks_.size());
+    const auto take_previous = [&](const Chunk &chunk, size_t hash) -> shared_ptr<ParsedChunk> {
+        for (auto it = lower_bound(previous.begin(), previous.end(), pair{hash, size_t{0}});
+             it != previous.end() && it->first == hash; ++it) {
+            if (!taken[it->second] && chunks_[it->second]->text == chunk.text) {
+                taken[it->second] = true;
+                return chunks_[it->second];
+            }
+        }
+        return nullptr;
+    };
+
+    const auto find_class = [](const runtime::Closure &declared_classes, const string &name) {
+        const auto it = declared_classes.find(name);
+        return it != declared_classes.end() ? it->second.Get() : nullptr;
+    };
+    const auto is_reusable = [&](const ParsedChunk &chunk, const runtime::Closure &declared_classes) {
+        return !chunk.has_import &&
+               all_of(chunk.references.begin(), chunk.references.end(), [&](const auto &ref) {
+                   return find_class(declared_classes, ref.first) == ref.second;
+               });
+    };
+    const auto parse_chunk = [&](const Chunk &chunk, size_t hash,
+                                 runtime::Closure &declared_classes) {
+        auto parsed = make_shared<ParsedChunk>();
+        parsed->text = string(chunk.text);
+        parsed->hash = hash;
+        parsed->first_line = chunk.first_line;
+        parsed->class_name = string(chunk.class_name);
+        ScanCode(chunk.text, 0, [&](string_view id) {
+            parsed->has_import = parsed->has_import || id == "import"sv;
+        });
+        unordered_set<string_view> ids;
+        ScanClassReferences(chunk.text, [&](string_view id) {
+            ids.insert(id);
+        });
+        for (const string_view id : ids) {
+            string name(id);
+            const runtime::Object *cls = find_class(declared_classes, name);
+            parsed->references.emplace_back(std::move(name), cls);
+        }
+        for (auto &statement : ParseChunk(chunk, declared_classes, &parsed->numbered_statements)) {
+            parsed->statements.push_back(std::move(statement));
+        }
+        if (!parsed->class_name.empty()) {
+            parsed->cls = std::as_const(declared_classes).at(parsed->class_name);
+        }
+        return parsed;
+    };
+
+    // Об ошибке разбора сообщает последовательный разбор, как и при параллельном разборе.
+    // Прочие исключения (например, ошибки исполнения импортируемого модуля) передаются
+    // вызывающему, чтобы модуль не исполнялся повторно
+    const auto parse_sequentially = [&] {
+        stats_ = {};
+        ViewStream input(source);
+        parse::Lexer lexer(input);
+        return ParseProgram(lexer);
+    };
+
+    Stats stats;
+    vector<shared_ptr<ParsedChunk>> chunks;
+    auto program = make_unique<ast::Compound>();
+    try {
+        runtime::Closure declared_classes;
+        for (const Chunk &chunk : SplitTopLevel(source)) {
+            const size_t hash = std::hash<string_view>{}(chunk.text);
+            auto reused = take_previous(chunk, hash);
+            if (reused && is_reusable(*reused, declared_classes)) {
+                if (reused->cls && !declared_classes.emplace(reused->class_name, reused->cls)) {
+                    throw ParseError("Class "s + reused->class_name + " already exists"s);
+                }
+                reused->MoveTo(chunk.first_line);
+                chunks.push_back(std::move(reused));
+                ++stats.reused;
+            } else {
+                chunks.push_back(parse_chunk(chunk, hash, declared_classes));
+                ++stats.parsed;
+            }
+            for (const auto &statement : chunks.back()->statements) {
+                program->AddStatement(make_unique<SharedStatement>(statement));
+            }
+        }
+    } catch (const ParseError &) {
+        return parse_sequentially();
+    } catch (const parse::LexerError &) {
+        return parse_sequentially();
+    }
+
+    chunks_ = std::move(chunks);
+    stats_ = stats;
+    return program;
+}
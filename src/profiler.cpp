@@ -0,0 +1,105 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <tuple>
+
+using namespace std;
+
+namespace runtime {
+
+namespace {
+
+// Подпись записи стека: Class.method:line, для кода вне методов - <module>:line
+string FrameLabel(const CallStack::Frame &frame) {
+    string label = frame.method ? frame.cls->GetName() + '.' + frame.method->name : "<module>"s;
+    if (frame.line != 0) {
+        label += ':';
+        label += to_string(frame.line);
+    }
+    return label;
+}
+
+} // namespace
+
+bool Profiler::FramesLess::operator()(const vector<CallStack::Frame> &lhs,
+                                      const vector<CallStack::Frame> &rhs) const {
+    auto tie_frame = [](const CallStack::Frame &frame) {
+        return tie(frame.cls, frame.method, frame.line);
+    };
+    return lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                                   [&tie_frame](const auto &l, const auto &r) {
+                                       return tie_frame(l) < tie_frame(r);
+                                   });
+}
+
+Profiler::Profiler(const CallStack &calls, chrono::microseconds interval)
+    : calls_(calls), interval_(interval) {}
+
+Profiler::~Profiler() {
+    Stop();
+}
+
+void Profiler::Start() {
+    if (thread_.joinable()) {
+        return;
+    }
+    stopping_ = false;
+    thread_ = thread([this] {
+        unique_lock lock(mutex_);
+        while (!stop_requested_.wait_for(lock, interval_, [this] { return stopping_; })) {
+            TakeSampleLocked();
+        }
+    });
+}
+
+void Profiler::Stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    stop_requested_.notify_one();
+    thread_.join();
+}
+
+void Profiler::TakeSample() {
+    lock_guard lock(mutex_);
+    TakeSampleLocked();
+}
+
+void Profiler::TakeSampleLocked() {
+    ++stacks_[calls_.Snapshot()];
+    ++samples_;
+}
+
+size_t Profiler::GetSampleCount() const {
+    lock_guard lock(mutex_);
+    return samples_;
+}
+
+void Profiler::WriteFolded(ostream &output) const {
+    // Стеки одноимённых классов сливаются в одну строку отчёта
+    map<string, size_t> folded;
+    {
+        lock_guard lock(mutex_);
+        for (const auto &[frames, count] : stacks_) {
+            string stack;
+            for (const auto &frame : frames) {
+                if (!stack.empty()) {
+                    stack += ';';
+                }
+                stack += FrameLabel(frame);
+            }
+            folded[stack] += count;
+        }
+    }
+    for (const auto &[stack, count] : folded) {
+        output << stack << ' ' << count << '\n';
+    }
+}
+
+} // namespace runtime
@@ -1,44 +1,136 @@
 #include "runtime.h"
 
 #include <cassert>
+#include <chrono>
+#include <cstring>
 #include <optional>
 
+#include <pthread.h>
+#include <sys/resource.h>
+
 using namespace std;
 
 namespace runtime {
 
-ObjectHolder::ObjectHolder(std::shared_ptr<Object> data) : data_(std::move(data)) {}
+namespace {
+const string SELF = "self"s;
+const string STR_METHOD = "__str__"s;
+const string EQ_METHOD = "__eq__"s;
+const string LT_METHOD = "__lt__"s;
+const string APPEND_METHOD = "append"s;
 
-void ObjectHolder::AssertIsValid() const {
-    assert(data_ != nullptr);
+// Выводит value в os, пустое значение выводится как None
+void PrintValue(std::ostream &os, const ObjectHolder &value, Context &context) {
+    if (value) {
+        value->Print(os, context);
+    } else {
+        os << "None"sv;
+    }
 }
 
-ObjectHolder ObjectHolder::Share(Object &object) {
-    // Возвращаем невладеющий shared_ptr (его deleter ничего не делает)
-    return ObjectHolder(
-        std::shared_ptr<Object>(&object, [](auto * /*p*/) { /* do nothing */ }));
+// Сравнивает значения, которые могут быть ключами словаря. Значения разных типов не равны
+bool KeysEqual(const ObjectHolder &lhs, const ObjectHolder &rhs) {
+    if (!lhs || !rhs) {
+        return !lhs && !rhs;
+    }
+    if (const auto *lhs_number = lhs.TryAs<Number>()) {
+        const auto *rhs_number = rhs.TryAs<Number>();
+        return rhs_number && lhs_number->GetValue() == rhs_number->GetValue();
+    }
+    if (const auto *lhs_string = lhs.TryAs<String>()) {
+        const auto *rhs_string = rhs.TryAs<String>();
+        return rhs_string && lhs_string->Size() == rhs_string->Size() &&
+               lhs_string->GetValue() == rhs_string->GetValue();
+    }
+    if (const auto *lhs_bool = lhs.TryAs<Bool>()) {
+        const auto *rhs_bool = rhs.TryAs<Bool>();
+        return rhs_bool && lhs_bool->GetValue() == rhs_bool->GetValue();
+    }
+    if (const auto *lhs_number = lhs.TryAs<BigNumber>()) {
+        const auto *rhs_number = rhs.TryAs<BigNumber>();
+        return rhs_number && lhs_number->GetValue() == rhs_number->GetValue();
+    }
+    return false;
 }
 
-ObjectHolder ObjectHolder::None() {
-    return ObjectHolder();
+// Возвращает true, если value может быть ключом словаря
+bool IsHashable(const ObjectHolder &value) {
+    return !value || value.TryAs<Number>() || value.TryAs<String>() || value.TryAs<Bool>() ||
+           value.TryAs<BigNumber>();
+}
+
+// Возвращает ObjectHolder, владеющий значением value, которое может быть ключом словаря.
+// Значение, которым value не владеет (например, константа программы), копируется
+ObjectHolder OwnedValue(const ObjectHolder &value) {
+    if (!value || value.IsOwner()) {
+        return value;
+    }
+    if (const auto *number = value.TryAs<Number>()) {
+        return ObjectHolder::Own(Number(number->GetValue()));
+    }
+    if (const auto *str = value.TryAs<String>()) {
+        return ObjectHolder::Own(String(str->GetValue()));
+    }
+    if (const auto *boolean = value.TryAs<Bool>()) {
+        return ObjectHolder::Own(Bool(boolean->GetValue()));
+    }
+    if (const auto *number = value.TryAs<BigNumber>()) {
+        return ObjectHolder::Own(BigNumber(number->GetValue()));
+    }
+    return value;
+}
+
+// Перемешивает биты хеша (финализатор MurmurHash3), чтобы младшие биты зависели от всех
+std::uint64_t MixHash(std::uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Операции над группой управляющих байт словаря, уложенной в 64-битное слово
+constexpr std::uint8_t EMPTY_CONTROL = 0x80;
+constexpr std::uint64_t LOW_BITS = 0x0101010101010101ULL;
+constexpr std::uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+std::uint64_t LoadGroup(const std::uint8_t *control) {
+    std::uint64_t group = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        group |= static_cast<std::uint64_t>(control[i]) << (8 * i);
+    }
+    return group;
+}
+
+// Возвращает маску байт группы, равных h2. Маска может содержать ложные срабатывания на
+// занятых ячейках, они отсеиваются сравнением полных хешей
+std::uint64_t MatchControl(std::uint64_t group, std::uint8_t h2) {
+    const std::uint64_t diff = group ^ (LOW_BITS * h2);
+    return (diff - LOW_BITS) & ~diff & HIGH_BITS;
+}
+
+std::uint64_t MatchEmpty(std::uint64_t group) {
+    return group & HIGH_BITS;
 }
 
-Object &ObjectHolder::operator*() const {
-    AssertIsValid();
-    return *Get();
+// Номер младшего байта, отмеченного в маске
+size_t LowestByte(std::uint64_t mask) {
+    return static_cast<size_t>(__builtin_ctzll(mask)) / 8;
 }
+} // namespace
 
-Object *ObjectHolder::operator->() const {
-    AssertIsValid();
-    return Get();
+void ObjectHolder::AssertIsValid() const {
+    assert(data_ != 0);
 }
 
-Object *ObjectHolder::Get() const {
-    return data_.get();
+ObjectHolder ObjectHolder::Share(Object &object) {
+    // Невладеющий ObjectHolder не изменяет счётчик ссылок объекта
+    return ObjectHolder(&object, false);
 }
 
-ObjectHolder::operator bool() const {
-    return Get() != nullptr;
+ObjectHolder ObjectHolder::None() {
+    return ObjectHolder();
 }
 
 bool IsTrue(const ObjectHolder &object) {
@@ -46,17 +138,241 @@ bool IsTrue(const ObjectHolder &object) {
         return ptr->GetValue() != 0;
     }
     if (const auto *ptr = object.TryAs<String>()) {
-        return !ptr->GetValue().empty();
+        return ptr->Size() != 0;
     }
     if (const auto *ptr = object.TryAs<Bool>()) {
         return ptr->GetValue();
     }
+    if (const auto *ptr = object.TryAs<List>()) {
+        return ptr->Size() != 0;
+    }
+    if (const auto *ptr = object.TryAs<Dict>()) {
+        return ptr->Size() != 0;
+    }
+    if (const auto *ptr = object.TryAs<BigNumber>()) {
+        return !ptr->GetValue().IsZero();
+    }
     return false;
 }
 
+SharedString::SharedString(size_t size) {
+    if (size <= INLINE_CAPACITY) {
+        inline_size_ = static_cast<std::uint8_t>(size);
+        return;
+    }
+    MemoryUsage::Allocate(sizeof(Buffer) + size);
+    void *memory = ::operator new(sizeof(Buffer) + size);
+    heap_ = new (memory) Buffer;
+    heap_->size = size;
+    heap_->refs.store(1, std::memory_order_relaxed);
+    inline_size_ = HEAP_TAG;
+}
+
+SharedString::SharedString(std::string_view str) : SharedString(str.size()) {
+    if (!str.empty()) {
+        std::memcpy(MutableData(), str.data(), str.size());
+    }
+}
+
+SharedString::SharedString(const SharedString &other) noexcept
+    : inline_size_(other.inline_size_) {
+    std::memcpy(inline_, other.inline_, INLINE_CAPACITY);
+    if (!IsInline()) {
+        heap_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SharedString::SharedString(SharedString &&other) noexcept : inline_size_(other.inline_size_) {
+    std::memcpy(inline_, other.inline_, INLINE_CAPACITY);
+    other.inline_size_ = 0;
+}
+
+SharedString &SharedString::operator=(const SharedString &other) noexcept {
+    if (this != &other) {
+        SharedString copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+SharedString &SharedString::operator=(SharedString &&other) noexcept {
+    if (this != &other) {
+        Release();
+        std::memcpy(inline_, other.inline_, INLINE_CAPACITY);
+        inline_size_ = std::exchange(other.inline_size_, 0);
+    }
+    return *this;
+}
+
+SharedString::~SharedString() {
+    Release();
+}
+
+void SharedString::Release() noexcept {
+    if (!IsInline() && heap_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        MemoryUsage::Release(sizeof(Buffer) + heap_->size);
+        heap_->~Buffer();
+        ::operator delete(heap_);
+    }
+    inline_size_ = 0;
+}
+
+SharedString SharedString::Concat(std::string_view lhs, std::string_view rhs) {
+    return Create(lhs.size() + rhs.size(), [lhs, rhs](char *data) {
+        if (!lhs.empty()) {
+            std::memcpy(data, lhs.data(), lhs.size());
+        }
+        if (!rhs.empty()) {
+            std::memcpy(data + lhs.size(), rhs.data(), rhs.size());
+        }
+    });
+}
+
+size_t SharedString::Hash() const {
+    if (IsInline()) {
+        return std::hash<std::string_view>{}(View());
+    }
+    size_t hash = heap_->hash.load(std::memory_order_relaxed);
+    if (hash == 0) {
+        // Гонка между потоками безопасна: все они запишут одно и то же значение
+        hash = std::hash<std::string_view>{}(View());
+        heap_->hash.store(hash, std::memory_order_relaxed);
+    }
+    return hash;
+}
+
+bool operator==(const SharedString &lhs, const SharedString &rhs) {
+    if (lhs.IsInline() != rhs.IsInline()) {
+        // Строки одной длины хранятся одинаково
+        return false;
+    }
+    if (lhs.IsInline()) {
+        return lhs.View() == rhs.View();
+    }
+    if (lhs.heap_ == rhs.heap_) {
+        return true;
+    }
+    if (lhs.heap_->size != rhs.heap_->size) {
+        return false;
+    }
+    const size_t lhs_hash = lhs.heap_->hash.load(std::memory_order_relaxed);
+    const size_t rhs_hash = rhs.heap_->hash.load(std::memory_order_relaxed);
+    if (lhs_hash != 0 && rhs_hash != 0 && lhs_hash != rhs_hash) {
+        return false;
+    }
+    return lhs.View() == rhs.View();
+}
+
+String::String(ObjectHolder left, ObjectHolder right)
+    : left_(std::move(left)), right_(std::move(right)),
+      size_(Of(left_).size_ + Of(right_).size_),
+      depth_(std::max(Of(left_).depth_, Of(right_).depth_) + 1) {
+    if (depth_ > MAX_ROPE_DEPTH) {
+        Flatten();
+    }
+}
+
+ObjectHolder String::Concat(const ObjectHolder &lhs, const ObjectHolder &rhs) {
+    // Дерево хранит только владеющие ссылки: строку, которой ObjectHolder не владеет
+    // (например, константу программы), дерево копирует. Копия плоской строки разделяет
+    // буфер с оригиналом
+    auto owned = [](const ObjectHolder &holder) {
+        return holder.IsOwner() ? holder : ObjectHolder::Own(String(Of(holder)));
+    };
+    return Join(owned(lhs), owned(rhs));
+}
+
+ObjectHolder String::Join(const ObjectHolder &lhs, const ObjectHolder &rhs) {
+    const String &left = Of(lhs);
+    const String &right = Of(rhs);
+    if (right.size_ == 0) {
+        return lhs;
+    }
+    if (left.size_ == 0) {
+        return rhs;
+    }
+    if (!left.left_ && !right.left_ && left.size_ + right.size_ <= LEAF_SIZE) {
+        return ObjectHolder::Own(
+            String(SharedString::Concat(left.value_.View(), right.value_.View())));
+    }
+    // Более низкое дерево присоединяется к краю более высокого на уровне своей высоты,
+    // а узлы на пути к нему перестраиваются
+    if (left.depth_ > right.depth_ + 1) {
+        return MakeBalanced(left.left_, Join(left.right_, rhs));
+    }
+    if (right.depth_ > left.depth_ + 1) {
+        return MakeBalanced(Join(lhs, right.left_), right.right_);
+    }
+    return ObjectHolder::Own(String(lhs, rhs));
+}
+
+ObjectHolder String::MakeBalanced(const ObjectHolder &lhs, const ObjectHolder &rhs) {
+    const String &left = Of(lhs);
+    const String &right = Of(rhs);
+    auto node = [](const ObjectHolder &l, const ObjectHolder &r) {
+        return ObjectHolder::Own(String(l, r));
+    };
+    // Высота ненулевая только у узлов дерева, поэтому у более высокого поддерева есть части
+    if (right.depth_ > left.depth_ + 1) {
+        const String &inner = Of(right.left_);
+        if (Of(right.right_).depth_ >= inner.depth_) {
+            return node(node(lhs, right.left_), right.right_);
+        }
+        return node(node(lhs, inner.left_), node(inner.right_, right.right_));
+    }
+    if (left.depth_ > right.depth_ + 1) {
+        const String &inner = Of(left.right_);
+        if (Of(left.left_).depth_ >= inner.depth_) {
+            return node(left.left_, node(left.right_, rhs));
+        }
+        return node(node(left.left_, inner.left_), node(inner.right_, rhs));
+    }
+    return node(lhs, rhs);
+}
+
+void String::Flatten() const {
+    value_ = SharedString::Create(size_, [this](char *data) {
+        CopyTo(data);
+    });
+    left_ = ObjectHolder::None();
+    right_ = ObjectHolder::None();
+    depth_ = 0;
+}
+
+char *String::CopyTo(char *out) const {
+    if (!left_) {
+        if (size_ != 0) {
+            std::memcpy(out, value_.View().data(), size_);
+        }
+        return out + size_;
+    }
+    return Of(right_).CopyTo(Of(left_).CopyTo(out));
+}
+
+ClassInstance::ClassInstance(const Class &cls) : class_(cls) {
+    GarbageCollector::Instance().Track(this);
+}
+
+ClassInstance::ClassInstance(const ClassInstance &other)
+    : Object(other), class_(other.class_),
+      closure_(other.closure_) {
+    GarbageCollector::Instance().Track(this);
+}
+
+ClassInstance::ClassInstance(ClassInstance &&other) noexcept
+    : class_(other.class_), closure_(std::move(other.closure_)) {
+    GarbageCollector::Instance().Track(this);
+}
+
+ClassInstance::~ClassInstance() {
+    if (collector_) {
+        collector_->Untrack(this);
+    }
+}
+
 void ClassInstance::Print(std::ostream &os, Context &context) {
-    if (HasMethod("__str__"s, 0)) {
-        Call("__str__"s, {}, context).Get()->Print(os, context);
+    if (const Method *str_method = class_.GetStrMethod()) {
+        Call(*str_method, {}, context).Get()->Print(os, context);
     } else {
         os << this;
     }
@@ -70,31 +386,690 @@ bool ClassInstance::HasMethod(const std::string &method, size_t argument_count)
 }
 
 ObjectHolder ClassInstance::Call(const std::string &method,
-                                 const std::vector<ObjectHolder> &actual_args,
+                                 ArgumentList actual_args,
                                  Context &context) {
-    if (HasMethod(method, actual_args.size())) {
-        Closure args;
-        args["self"s] = ObjectHolder::Share(*this);
+    const Method *method_ptr = class_.GetMethod(method);
+    if (!method_ptr || method_ptr->formal_params.size() != actual_args.size()) {
+        throw RuntimeError("Method "s + method + " not found"s);
+    }
+    return Call(*method_ptr, actual_args, context);
+}
+
+ObjectHolder ClassInstance::Call(const Method &method, ArgumentList actual_args, Context &context) {
+    context.GetStats().CountMethodCall();
+    if (!method.cache) {
+        return Invoke(method, actual_args, context);
+    }
+    if (const ObjectHolder *cached = method.cache->Find(actual_args)) {
+        return *cached;
+    }
+    ObjectHolder result = Invoke(method, actual_args, context);
+    method.cache->Insert(actual_args, result);
+    return result;
+}
+
+ObjectHolder ClassInstance::Invoke(const Method &method,
+                                   ArgumentList actual_args,
+                                   Context &context) {
+    const Method *method_ptr = &method;
+    auto &frames = FrameStack::Instance();
+    // Глубина и запас стека проверяются до входа в метод, чтобы рекурсия завершалась ошибкой,
+    // а не переполнением стека
+    const size_t max_call_depth = context.GetLimits().max_call_depth;
+    if (max_call_depth != 0 && frames.Depth() >= max_call_depth) {
+        throw ExecutionLimitExceeded(ExecutionLimitExceeded::Reason::CallDepth,
+                                     "Maximum call depth of "s +
+                                         std::to_string(max_call_depth) + " exceeded"s);
+    }
+    if (frames.IsStackExhausted()) {
+        throw ExecutionLimitExceeded(ExecutionLimitExceeded::Reason::CallDepth,
+                                     "Maximum call depth exceeded: stack is exhausted at depth "s +
+                                         std::to_string(frames.Depth()));
+    }
+    context.CountStep();
+    Closure &args = frames.Push(std::max(method_ptr->locals_count, actual_args.size() + 1));
+    auto &state = context.GetReturnState();
+
+    // Кадр возвращается в стек и при выходе из метода по исключению
+    auto &calls = CallStack::Instance();
+    calls.Push(class_, *method_ptr);
+    struct FrameGuard {
+        FrameStack &frames;
+        CallStack &calls;
+        ReturnState &state;
+        const Closure *outer_frame;
+        ~FrameGuard() {
+            state.frame = outer_frame;
+            state.active = false;
+            state.tail_method = nullptr;
+            calls.Pop();
+            frames.Pop();
+        }
+    } guard{frames, calls, state, std::exchange(state.frame, &args)};
+
+    GetOrInsert(args, SELF, context) = ObjectHolder::Share(*this);
+    for (size_t i = 0; i < actual_args.size(); ++i) {
+        GetOrInsert(args, method_ptr->formal_params[i], context) = actual_args[i];
+    }
 
-        const Method *method_ptr = class_.GetMethod(method);
+    for (;;) {
+        ObjectHolder result = method_ptr->body->Execute(args, context);
+        if (!state.active) {
+            return result;
+        }
+        state.active = false;
+        if (!state.tail_method) {
+            return std::move(state.value);
+        }
 
-        for (size_t i = 0; i < actual_args.size(); ++i) {
-            args[method_ptr->formal_params[i]] = actual_args[i];
+        // Хвостовой вызов: кадр заполняется параметрами следующего метода
+        const std::string &tail_method = *std::exchange(state.tail_method, nullptr);
+        if (state.tail_self != this) {
+            // self в кадре был переназначен, вызываем метод другого объекта обычным образом
+            const TrackedVector<ObjectHolder> tail_args = std::move(state.tail_args);
+            state.tail_args.clear();
+            return state.tail_self->Call(tail_method, tail_args, context);
+        }
+        const Method *next_method = class_.GetMethod(tail_method);
+        if (!next_method || next_method->formal_params.size() != state.tail_args.size()) {
+            state.tail_args.clear();
+            throw RuntimeError("Method "s + tail_method + " not found"s);
+        }
+        if (next_method->cache) {
+            if (next_method != method_ptr) {
+                // Другой чистый метод вызывается через кэш
+                const TrackedVector<ObjectHolder> tail_args = std::move(state.tail_args);
+                state.tail_args.clear();
+                return Call(*next_method, tail_args, context);
+            }
+            // Хвостовая рекурсия чистого метода выполняется в том же кадре, поэтому кэш
+            // только читается: результат сохранит внешний вызов
+            if (const ObjectHolder *cached = next_method->cache->Find(state.tail_args)) {
+                state.tail_args.clear();
+                return *cached;
+            }
         }
-        return method_ptr->body->Execute(args, context);
+        method_ptr = next_method;
+        calls.Replace(*method_ptr);
+        context.GetStats().CountMethodCall();
+        context.CountStep();
+
+        args.clear();
+        args.reserve(method_ptr->locals_count);
+        GetOrInsert(args, SELF, context) = ObjectHolder::Share(*this);
+        for (size_t i = 0; i < state.tail_args.size(); ++i) {
+            GetOrInsert(args, method_ptr->formal_params[i], context) =
+                std::move(state.tail_args[i]);
+        }
+        state.tail_args.clear();
     }
+}
 
-    throw std::runtime_error("Method "s + method + " not found"s);
+Context::Context() noexcept
+    : outer_stats_(std::exchange(ExecutionStats::current_, &stats_)),
+      memory_baseline_(MemoryUsage::bytes_),
+      outer_context_(std::exchange(MemoryUsage::context_, this)) {
+    MemoryUsage::watermark_ = memory_baseline_;
 }
 
-const Method *Class::GetMethod(const std::string &name) const {
-    for (const auto &method : methods_) {
-        if (method.name == name) {
-            return &method;
+Context::~Context() {
+    ExecutionStats::current_ = outer_stats_;
+    MemoryUsage::context_ = outer_context_;
+    if (outer_context_) {
+        // Память, занятая во вложенном контексте, занята и во внешнем
+        auto &outer = *outer_context_;
+        outer.peak_memory_ =
+            std::max(outer.peak_memory_, memory_baseline_ + peak_memory_ - outer.memory_baseline_);
+        MemoryUsage::watermark_ = outer.memory_baseline_ + outer.peak_memory_;
+    } else {
+        MemoryUsage::watermark_ = std::numeric_limits<std::int64_t>::max();
+    }
+}
+
+void MemoryUsage::OnNewPeak(size_t size) {
+    if (!context_) {
+        return;
+    }
+    Context &context = *context_;
+    const std::int64_t usage = bytes_ - context.memory_baseline_;
+    const std::uint64_t limit = context.limits_.max_memory;
+    if (limit != 0 && usage > static_cast<std::int64_t>(limit)) {
+        bytes_ -= static_cast<std::int64_t>(size);
+        throw ExecutionLimitExceeded(ExecutionLimitExceeded::Reason::Memory,
+                                     "Memory quota of "s + std::to_string(limit) +
+                                         " bytes exceeded"s);
+    }
+    context.peak_memory_ = usage;
+    watermark_ = bytes_;
+}
+
+void Context::SetLimits(const ExecutionLimits &limits) {
+    limits_ = limits;
+    steps_ = 0;
+    ScheduleCheck();
+}
+
+void Context::CheckLimits() {
+    using Reason = ExecutionLimitExceeded::Reason;
+    if (limits_.max_steps != 0 && steps_ > limits_.max_steps) {
+        throw ExecutionLimitExceeded(Reason::Steps, "Execution step budget of "s +
+                                                        std::to_string(limits_.max_steps) +
+                                                        " exceeded"s);
+    }
+    if (limits_.deadline && std::chrono::steady_clock::now() >= *limits_.deadline) {
+        throw ExecutionLimitExceeded(Reason::Deadline, "Execution deadline exceeded"s);
+    }
+    ScheduleCheck();
+}
+
+void Context::ScheduleCheck() noexcept {
+    next_check_ = std::numeric_limits<std::uint64_t>::max();
+    if (limits_.deadline) {
+        next_check_ = steps_ + DEADLINE_CHECK_INTERVAL;
+    }
+    if (limits_.max_steps != 0) {
+        next_check_ = std::min(next_check_, limits_.max_steps + 1);
+    }
+}
+
+std::string_view ExecutionStats::GetName(NodeType type) {
+    static constexpr std::array<std::string_view, static_cast<size_t>(NodeType::COUNT)> NAMES = {
+        "Constant"sv,   "None"sv,        "VariableValue"sv, "Assignment"sv, "FieldAssignment"sv,
+        "IndexAssignment"sv, "Print"sv,  "MethodCall"sv,    "NewInstance"sv, "ListLiteral"sv,
+        "DictLiteral"sv, "Index"sv,      "Slice"sv,         "Stringify"sv,  "Length"sv,
+        "Add"sv,        "Sub"sv,         "Mult"sv,          "Div"sv,        "Or"sv,
+        "And"sv,        "Not"sv,         "Comparison"sv,    "Compound"sv,   "MethodBody"sv,
+        "Return"sv,     "ClassDefinition"sv, "IfElse"sv,    "While"sv,      "ForRange"sv,
+        "ForEach"sv,    "Import"sv};
+    return NAMES[static_cast<size_t>(type)];
+}
+
+std::string_view ExecutionStats::GetName(ObjectType type) {
+    static constexpr std::array<std::string_view, static_cast<size_t>(ObjectType::COUNT)> NAMES =
+        {"Number"sv, "BigNumber"sv, "String"sv,        "Bool"sv, "List"sv,
+         "Dict"sv,   "Class"sv,     "ClassInstance"sv, "Other"sv};
+    return NAMES[static_cast<size_t>(type)];
+}
+
+CallStack &CallStack::Instance() {
+    thread_local CallStack calls;
+    return calls;
+}
+
+void CallStack::Push(const Class &cls, const Method &method) noexcept {
+    const size_t depth = depth_.load(std::memory_order_relaxed) + 1;
+    if (depth < MAX_DEPTH) {
+        auto &frame = frames_[depth];
+        frame.cls.store(&cls, std::memory_order_relaxed);
+        frame.method.store(&method, std::memory_order_relaxed);
+        frame.line.store(0, std::memory_order_relaxed);
+    }
+    // Запись заполнена до того, как её увидит профилировщик
+    depth_.store(depth, std::memory_order_release);
+}
+
+void CallStack::Replace(const Method &method) noexcept {
+    const size_t depth = depth_.load(std::memory_order_relaxed);
+    if (depth < MAX_DEPTH) {
+        frames_[depth].method.store(&method, std::memory_order_relaxed);
+    }
+}
+
+void CallStack::Pop() noexcept {
+    depth_.store(depth_.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+}
+
+std::vector<CallStack::Frame> CallStack::Snapshot() const {
+    const size_t depth = std::min(depth_.load(std::memory_order_acquire), MAX_DEPTH - 1);
+    std::vector<Frame> result(depth + 1);
+    for (size_t i = 0; i <= depth; ++i) {
+        result[i].cls = frames_[i].cls.load(std::memory_order_relaxed);
+        result[i].method = frames_[i].method.load(std::memory_order_relaxed);
+        result[i].line = frames_[i].line.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+Closure::ConstIterator &Closure::ConstIterator::operator++() {
+    ++it_;
+    SkipHidden();
+    return *this;
+}
+
+void Closure::ConstIterator::SkipHidden() {
+    for (;;) {
+        const Map &bindings = layer_ ? layer_->bindings : closure_->bindings_;
+        if (it_ == bindings.end()) {
+            const Layer *next = layer_ ? layer_->base.get() : closure_->base_.get();
+            if (!next) {
+                *this = {};
+                return;
+            }
+            layer_ = next;
+            it_ = next->bindings.begin();
+        } else if (layer_ && closure_->IsHidden(it_->first, layer_)) {
+            ++it_;
+        } else {
+            return;
         }
     }
-    if (parent_) {
-        for (const auto &method : parent_->methods_) {
+}
+
+Closure::const_iterator Closure::begin() const {
+    ConstIterator it(this, nullptr, bindings_.begin());
+    it.SkipHidden();
+    return it;
+}
+
+const ObjectHolder &Closure::at(const std::string &name) const {
+    const auto it = find(name);
+    if (it == end()) {
+        throw std::out_of_range("Variable "s + name + " not found"s);
+    }
+    return it->second;
+}
+
+ObjectHolder &Closure::at(const std::string &name) {
+    if (const auto it = bindings_.find(name); it != bindings_.end()) {
+        return it->second;
+    }
+    if (find(name) == end()) {
+        throw std::out_of_range("Variable "s + name + " not found"s);
+    }
+    return Insert(name);
+}
+
+bool Closure::emplace(const std::string &name, ObjectHolder value) {
+    if (find(name) != end()) {
+        return false;
+    }
+    bindings_.emplace(name, std::move(value));
+    return true;
+}
+
+Closure Closure::Fork() {
+    if (!bindings_.empty()) {
+        auto layer = std::make_shared<Layer>();
+        layer->size = size();
+        if (base_ && base_->depth >= MAX_LAYERS) {
+            // Поиск по длинной цепочке слоёв медленный, поэтому все слои сливаются в один
+            layer->bindings.reserve(layer->size);
+            for (const auto &[name, value] : *this) {
+                layer->bindings.emplace(name, value);
+            }
+        } else {
+            layer->bindings = std::move(bindings_);
+            layer->base = std::move(base_);
+            layer->depth = layer->base ? layer->base->depth + 1 : 1;
+        }
+        bindings_ = Map();
+        base_ = std::move(layer);
+        shadowed_ = 0;
+    }
+    Closure fork;
+    fork.base_ = base_;
+    return fork;
+}
+
+Closure::const_iterator Closure::FindInLayers(const std::string &name) const {
+    for (const Layer *layer = base_.get(); layer; layer = layer->base.get()) {
+        if (const auto it = layer->bindings.find(name); it != layer->bindings.end()) {
+            return {this, layer, it};
+        }
+    }
+    return end();
+}
+
+ObjectHolder &Closure::Insert(const std::string &name) {
+    const auto inherited = base_ ? FindInLayers(name) : end();
+    ObjectHolder &variable =
+        bindings_.emplace(name, inherited != end() ? inherited->second : ObjectHolder())
+            .first->second;
+    if (inherited != end()) {
+        ++shadowed_;
+    }
+    return variable;
+}
+
+bool Closure::IsHidden(const std::string &name, const Layer *layer) const {
+    if (bindings_.count(name) != 0) {
+        return true;
+    }
+    for (const Layer *upper = base_.get(); upper != layer; upper = upper->base.get()) {
+        if (upper->bindings.count(name) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+FrameStack &FrameStack::Instance() {
+    thread_local FrameStack frames;
+    return frames;
+}
+
+FrameStack::FrameStack() {
+    // Стек потока растёт вниз, от stack_begin + stack_size к stack_begin
+    uintptr_t stack_begin = 0;
+    size_t stack_size = 0;
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+        void *addr = nullptr;
+        if (pthread_attr_getstack(&attr, &addr, &stack_size) == 0) {
+            stack_begin = reinterpret_cast<uintptr_t>(addr);
+        }
+        pthread_attr_destroy(&attr);
+    }
+    if (stack_begin == 0) {
+        // Границы стека неизвестны: его вершиной считается кадр этой функции, а размером -
+        // ограничение RLIMIT_STACK
+        rlimit limit{};
+        const auto top = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+        if (getrlimit(RLIMIT_STACK, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY ||
+            limit.rlim_cur >= top) {
+            return;
+        }
+        stack_size = static_cast<size_t>(limit.rlim_cur);
+        stack_begin = top - stack_size;
+    }
+    stack_limit_ = stack_begin + std::min(STACK_RESERVE, stack_size / 2);
+}
+
+Closure &FrameStack::Push(size_t locals_count) {
+    if (depth_ == frames_.size()) {
+        frames_.push_back(std::make_unique<Closure>());
+    }
+    Closure &frame = *frames_[depth_++];
+    frame.reserve(locals_count);
+    return frame;
+}
+
+void FrameStack::Pop() noexcept {
+    frames_[--depth_]->clear();
+}
+
+void List::Print(std::ostream &os, Context &context) {
+    if (printing_) {
+        os << "[...]"sv;
+        return;
+    }
+    printing_ = true;
+    os << '[';
+    std::string_view delim;
+    for (const auto &item : items_) {
+        os << delim;
+        PrintValue(os, item, context);
+        delim = ", "sv;
+    }
+    os << ']';
+    printing_ = false;
+}
+
+ObjectHolder &List::At(long long index) {
+    const auto size = static_cast<long long>(items_.size());
+    if (index < 0) {
+        index += size;
+    }
+    if (index < 0 || index >= size) {
+        throw RuntimeError("List index out of range"s);
+    }
+    return items_[static_cast<size_t>(index)];
+}
+
+List List::Slice(std::optional<long long> start, std::optional<long long> stop) const {
+    const auto size = static_cast<long long>(items_.size());
+    auto clamp = [size](long long index) {
+        if (index < 0) {
+            index += size;
+        }
+        return std::clamp(index, 0LL, size);
+    };
+    const long long first = start ? clamp(*start) : 0;
+    const long long last = stop ? clamp(*stop) : size;
+    if (first >= last) {
+        return List();
+    }
+    return List(TrackedVector<ObjectHolder>(items_.begin() + first, items_.begin() + last));
+}
+
+bool List::HasMethod(const std::string &method, size_t argument_count) {
+    return method == APPEND_METHOD && argument_count == 1;
+}
+
+ObjectHolder List::Call(const std::string &method,
+                        ArgumentList actual_args,
+                        [[maybe_unused]] Context &context) {
+    if (!HasMethod(method, actual_args.size())) {
+        throw RuntimeError("Method "s + method + " not found"s);
+    }
+    Append(actual_args[0]);
+    return ObjectHolder::None();
+}
+
+std::uint64_t HashKey(const ObjectHolder &key) {
+    if (!key) {
+        return MixHash(0x4e6f6e65);
+    }
+    if (const auto *number = key.TryAs<Number>()) {
+        return MixHash(static_cast<std::uint64_t>(number->GetValue()));
+    }
+    if (const auto *str = key.TryAs<String>()) {
+        return MixHash(str->GetValue().Hash());
+    }
+    if (const auto *boolean = key.TryAs<Bool>()) {
+        return MixHash(boolean->GetValue() ? 0x54727565 : 0x46616c73);
+    }
+    if (const auto *number = key.TryAs<BigNumber>()) {
+        return MixHash(number->GetValue().Hash());
+    }
+    throw RuntimeError("Unhashable dictionary key"s);
+}
+
+void Dict::Print(std::ostream &os, Context &context) {
+    if (printing_) {
+        os << "{...}"sv;
+        return;
+    }
+    printing_ = true;
+    os << '{';
+    std::string_view delim;
+    for (const auto &entry : entries_) {
+        os << delim;
+        PrintValue(os, entry.key, context);
+        os << ": "sv;
+        PrintValue(os, entry.value, context);
+        delim = ", "sv;
+    }
+    os << '}';
+    printing_ = false;
+}
+
+ObjectHolder *Dict::Find(const ObjectHolder &key) {
+    const size_t index = FindIndex(key, HashKey(key));
+    return index == NOT_FOUND ? nullptr : &entries_[index].value;
+}
+
+const ObjectHolder *Dict::Find(const ObjectHolder &key) const {
+    const size_t index = FindIndex(key, HashKey(key));
+    return index == NOT_FOUND ? nullptr : &entries_[index].value;
+}
+
+ObjectHolder &Dict::At(const ObjectHolder &key) {
+    if (ObjectHolder *value = Find(key)) {
+        return *value;
+    }
+    throw RuntimeError("Key not found in dictionary"s);
+}
+
+ObjectHolder &Dict::Set(const ObjectHolder &key, ObjectHolder value) {
+    const std::uint64_t hash = HashKey(key);
+    if (const size_t index = FindIndex(key, hash); index != NOT_FOUND) {
+        return entries_[index].value = std::move(value);
+    }
+    Reserve(entries_.size() + 1);
+    entries_.push_back({key, std::move(value), hash});
+    InsertIndex(static_cast<std::uint32_t>(entries_.size() - 1), hash);
+    return entries_.back().value;
+}
+
+void Dict::Reserve(size_t count) {
+    if (count == 0) {
+        return;
+    }
+    // Таблица заполняется не больше чем на 7/8, чтобы в ней всегда оставались пустые ячейки
+    size_t capacity = std::max(control_.size(), GROUP_WIDTH);
+    while (count * 8 > capacity * 7) {
+        capacity *= 2;
+    }
+    if (capacity != control_.size()) {
+        Rehash(capacity);
+    }
+    if (count > entries_.capacity()) {
+        entries_.reserve(std::max(count, entries_.capacity() * 2));
+    }
+}
+
+TrackedVector<Dict::Entry> Dict::TakeItems() {
+    control_.clear();
+    slots_.clear();
+    return std::exchange(entries_, {});
+}
+
+size_t Dict::FindIndex(const ObjectHolder &key, std::uint64_t hash) const {
+    if (control_.empty()) {
+        return NOT_FOUND;
+    }
+    const size_t group_mask = control_.size() / GROUP_WIDTH - 1;
+    const auto h2 = static_cast<std::uint8_t>(hash & 0x7f);
+    size_t group = static_cast<size_t>(hash >> 7) & group_mask;
+    // Группы перебираются с треугольным шагом, который обходит все группы таблицы
+    for (size_t step = 1;; ++step) {
+        const size_t first_slot = group * GROUP_WIDTH;
+        const std::uint64_t control = LoadGroup(&control_[first_slot]);
+        for (std::uint64_t match = MatchControl(control, h2); match != 0; match &= match - 1) {
+            const std::uint32_t index = slots_[first_slot + LowestByte(match)];
+            const Entry &entry = entries_[index];
+            if (entry.hash == hash && KeysEqual(entry.key, key)) {
+                return index;
+            }
+        }
+        if (MatchEmpty(control) != 0) {
+            return NOT_FOUND;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+void Dict::InsertIndex(std::uint32_t entry_index, std::uint64_t hash) {
+    const size_t group_mask = control_.size() / GROUP_WIDTH - 1;
+    size_t group = static_cast<size_t>(hash >> 7) & group_mask;
+    for (size_t step = 1;; ++step) {
+        const size_t first_slot = group * GROUP_WIDTH;
+        if (const std::uint64_t empty = MatchEmpty(LoadGroup(&control_[first_slot]))) {
+            const size_t slot = first_slot + LowestByte(empty);
+            control_[slot] = static_cast<std::uint8_t>(hash & 0x7f);
+            slots_[slot] = entry_index;
+            return;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+void Dict::Rehash(size_t capacity) {
+    control_.assign(capacity, EMPTY_CONTROL);
+    slots_.assign(capacity, 0);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        InsertIndex(static_cast<std::uint32_t>(i), entries_[i].hash);
+    }
+}
+
+CallCache::CallCache(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+std::optional<std::uint64_t> CallCache::HashArgs(ArgumentList args) {
+    std::uint64_t hash = args.size();
+    for (const ObjectHolder &arg : args) {
+        if (!IsHashable(arg)) {
+            return std::nullopt;
+        }
+        hash = MixHash(hash ^ HashKey(arg));
+    }
+    return hash;
+}
+
+CallCache::EntryList::iterator CallCache::FindEntry(ArgumentList args, std::uint64_t hash) {
+    auto [begin, end] = index_.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        const Entry &entry = *it->second;
+        if (entry.args.size() == args.size() &&
+            std::equal(entry.args.begin(), entry.args.end(), args.begin(), KeysEqual)) {
+            return it->second;
+        }
+    }
+    return entries_.end();
+}
+
+const ObjectHolder *CallCache::Find(ArgumentList args) {
+    if (frozen_) {
+        return nullptr;
+    }
+    const auto hash = HashArgs(args);
+    if (!hash) {
+        ++stats_.uncacheable;
+        return nullptr;
+    }
+    const auto entry = FindEntry(args, *hash);
+    if (entry == entries_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, entry);
+    return &entry->result;
+}
+
+void CallCache::Insert(ArgumentList args, const ObjectHolder &result) {
+    if (frozen_) {
+        return;
+    }
+    // Изменяемый результат (список, словарь, объект) нельзя разделять между вызовами
+    const auto hash = HashArgs(args);
+    if (!hash || !IsHashable(result) || FindEntry(args, *hash) != entries_.end()) {
+        return;
+    }
+
+    if (entries_.size() == capacity_) {
+        const Entry &oldest = entries_.back();
+        auto [begin, end] = index_.equal_range(oldest.hash);
+        for (auto it = begin; it != end; ++it) {
+            if (&*it->second == &oldest) {
+                index_.erase(it);
+                break;
+            }
+        }
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+
+    Entry entry{{}, OwnedValue(result), *hash};
+    entry.args.reserve(args.size());
+    for (const ObjectHolder &arg : args) {
+        entry.args.push_back(OwnedValue(arg));
+    }
+    entries_.push_front(std::move(entry));
+    index_.emplace(*hash, entries_.begin());
+}
+
+Class::Class(std::string name, std::vector<Method> methods, const Class *parent)
+    : name_(std::move(name)), methods_(std::move(methods)), parent_(parent) {
+    const Method *str_method = GetMethod(STR_METHOD);
+    if (str_method && str_method->formal_params.empty()) {
+        str_method_ = str_method;
+    }
+}
+
+const Method *Class::GetMethod(const std::string &name) const {
+    for (const Class *cls = this; cls; cls = cls->parent_) {
+        for (const auto &method : cls->methods_) {
             if (method.name == name) {
                 return &method;
             }
@@ -107,30 +1082,200 @@ void Class::Print(ostream &os, [[maybe_unused]] Context &context) {
     os << "Class "sv << name_;
 }
 
+bool IsInteger(const ObjectHolder &object) {
+    return object.TryAs<Number>() || object.TryAs<BigNumber>();
+}
+
+BigInt ToBigInt(const ObjectHolder &object) {
+    if (const auto *number = object.TryAs<Number>()) {
+        return number->GetValue();
+    }
+    if (const auto *number = object.TryAs<BigNumber>()) {
+        return number->GetValue();
+    }
+    throw RuntimeError("Object is not an integer"s);
+}
+
+ObjectHolder MakeInteger(BigInt value) {
+    if (value.FitsInt64()) {
+        return ObjectHolder::Own(Number(value.ToInt64()));
+    }
+    return ObjectHolder::Own(BigNumber(std::move(value)));
+}
+
 void Bool::Print(std::ostream &os, [[maybe_unused]] Context &context) {
     os << (GetValue() ? "True"sv : "False"sv);
 }
 
+GarbageCollector &GarbageCollector::Instance() {
+    thread_local GarbageCollector collector;
+    return collector;
+}
+
+void GarbageCollector::Track(ClassInstance *instance) {
+    instance->collector_ = this;
+    instance->gc_next_ = head_;
+    if (head_) {
+        head_->gc_prev_ = instance;
+    }
+    head_ = instance;
+
+    ++allocated_since_collect_;
+    ++stats_.tracked;
+}
+
+void GarbageCollector::Detach(ClassInstance &instance) {
+    if (instance.collector_ == this) {
+        Untrack(&instance);
+        instance.collector_ = nullptr;
+    }
+}
+
+void GarbageCollector::Untrack(ClassInstance *instance) {
+    if (instance->gc_prev_) {
+        instance->gc_prev_->gc_next_ = instance->gc_next_;
+    } else {
+        head_ = instance->gc_next_;
+    }
+    if (instance->gc_next_) {
+        instance->gc_next_->gc_prev_ = instance->gc_prev_;
+    }
+    instance->gc_prev_ = instance->gc_next_ = nullptr;
+
+    --stats_.tracked;
+}
+
+size_t GarbageCollector::Collect() {
+    const auto start = std::chrono::steady_clock::now();
+
+    // Вызывает fn для каждого отслеживаемого экземпляра, на который ссылается поле holder
+    auto for_each_child = [this](ClassInstance *instance, auto fn) {
+        for (const auto &field : instance->closure_) {
+            const ObjectHolder &holder = field.second;
+            auto *child = holder.TryAs<ClassInstance>();
+            if (child && child->collector_ == this) {
+                fn(child, holder);
+            }
+        }
+    };
+
+    // Счётчик ссылок каждого экземпляра - количество его владельцев. Экземпляры, которыми
+    // не владеет ни один ObjectHolder (например, созданные на стеке), всегда считаются корнями
+    for (auto *instance = head_; instance; instance = instance->gc_next_) {
+        const long owners = static_cast<long>(instance->ref_count_.Get());
+        instance->gc_refs_ = owners > 0 ? owners : 1;
+    }
+
+    // Вычитаем владеющие ссылки из полей других экземпляров. Положительный остаток означает,
+    // что на экземпляр ссылаются извне кучи: из Closure или со стека интерпретатора
+    for (auto *instance = head_; instance; instance = instance->gc_next_) {
+        for_each_child(instance, [](ClassInstance *child, const ObjectHolder &holder) {
+            if (holder.IsOwner()) {
+                --child->gc_refs_;
+            }
+        });
+    }
+
+    // Помечаем всё, что достижимо из корней
+    std::vector<ClassInstance *> worklist;
+    for (auto *instance = head_; instance; instance = instance->gc_next_) {
+        if (instance->gc_refs_ > 0) {
+            worklist.push_back(instance);
+        }
+    }
+    while (!worklist.empty()) {
+        auto *instance = worklist.back();
+        worklist.pop_back();
+        for_each_child(instance, [&worklist](ClassInstance *child, const ObjectHolder &) {
+            if (child->gc_refs_ <= 0) {
+                child->gc_refs_ = 1;
+                worklist.push_back(child);
+            }
+        });
+    }
+
+    // Непомеченные экземпляры удерживают друг друга только циклическими ссылками.
+    // Пока поля очищаются, экземпляры удерживаются вектором garbage, чтобы список
+    // отслеживаемых объектов не менялся во время обхода
+    std::vector<ObjectHolder> garbage;
+    for (auto *instance = head_; instance; instance = instance->gc_next_) {
+        if (instance->gc_refs_ <= 0) {
+            garbage.push_back(ObjectHolder(instance, true));
+        }
+    }
+    for (const auto &instance : garbage) {
+        Closure fields;
+        fields.swap(static_cast<ClassInstance &>(*instance).closure_);
+    }
+    const size_t freed = garbage.size();
+    garbage.clear();
+
+    allocated_since_collect_ = 0;
+    survivors_ = stats_.tracked;
+
+    const auto pause = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    ++stats_.collections;
+    stats_.freed += freed;
+    stats_.last_pause = pause;
+    stats_.total_pause += pause;
+    stats_.max_pause = std::max(stats_.max_pause, pause);
+
+    return freed;
+}
+
 bool Equal(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &context) {
     if (lhs.TryAs<Number>() && rhs.TryAs<Number>()) {
         return lhs.TryAs<Number>()->GetValue() == rhs.TryAs<Number>()->GetValue();
     }
     if (lhs.TryAs<String>() && rhs.TryAs<String>()) {
-        return lhs.TryAs<String>()->GetValue() == rhs.TryAs<String>()->GetValue();
+        // Строки разной длины не приводятся к плоскому виду
+        return lhs.TryAs<String>()->Size() == rhs.TryAs<String>()->Size() &&
+               lhs.TryAs<String>()->GetValue() == rhs.TryAs<String>()->GetValue();
     }
     if (lhs.TryAs<Bool>() && rhs.TryAs<Bool>()) {
         return lhs.TryAs<Bool>()->GetValue() == rhs.TryAs<Bool>()->GetValue();
     }
+    if (IsInteger(lhs) && IsInteger(rhs)) {
+        return ToBigInt(lhs) == ToBigInt(rhs);
+    }
     if (!lhs && !rhs) {
         return true;
     }
-    if (lhs.TryAs<ClassInstance>() && lhs.TryAs<ClassInstance>()->HasMethod("__eq__"s, 1)) {
+    if (lhs.TryAs<List>() && rhs.TryAs<List>()) {
+        const auto &lhs_items = lhs.TryAs<List>()->Items();
+        const auto &rhs_items = rhs.TryAs<List>()->Items();
+        if (lhs_items.size() != rhs_items.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs_items.size(); ++i) {
+            if (!Equal(lhs_items[i], rhs_items[i], context)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (lhs.TryAs<Dict>() && rhs.TryAs<Dict>()) {
+        const auto &lhs_items = lhs.TryAs<Dict>()->Items();
+        const auto *rhs_dict = rhs.TryAs<Dict>();
+        if (lhs_items.size() != rhs_dict->Size()) {
+            return false;
+        }
+        for (const auto &entry : lhs_items) {
+            const ObjectHolder *value = rhs_dict->Find(entry.key);
+            if (!value || !Equal(entry.value, *value, context)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (lhs.TryAs<ClassInstance>() && lhs.TryAs<ClassInstance>()->HasMethod(EQ_METHOD, 1)) {
         return lhs.TryAs<ClassInstance>()
-            ->Call("__eq__"s, {rhs}, context)
+            ->Call(EQ_METHOD, {rhs}, context)
             .TryAs<Bool>()
             ->GetValue();
     }
-    throw std::runtime_error("Cannot compare objects for equality"s);
+    throw RuntimeError("Cannot compare objects for equality"s);
 }
 
 bool Less(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &context) {
@@ -143,13 +1288,41 @@ bool Less(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &context) {
     if (lhs.TryAs<Bool>() && rhs.TryAs<Bool>()) {
         return lhs.TryAs<Bool>()->GetValue() < rhs.TryAs<Bool>()->GetValue();
     }
-    if (lhs.TryAs<ClassInstance>() && lhs.TryAs<ClassInstance>()->HasMethod("__lt__"s, 1)) {
+    if (IsInteger(lhs) && IsInteger(rhs)) {
+        return ToBigInt(lhs) < ToBigInt(rhs);
+    }
+    if (lhs.TryAs<ClassInstance>() && lhs.TryAs<ClassInstance>()->HasMethod(LT_METHOD, 1)) {
         return lhs.TryAs<ClassInstance>()
-            ->Call("__lt__"s, {rhs}, context)
+            ->Call(LT_METHOD, {rhs}, context)
             .TryAs<Bool>()
             ->GetValue();
     }
-    throw std::runtime_error("Cannot compare objects for less"s);
+    throw RuntimeError("Cannot compare objects for less"s);
+}
+
+bool Contains(const ObjectHolder &item, const ObjectHolder &container, Context &context) {
+    if (const auto *dict = container.TryAs<Dict>()) {
+        return dict->Find(item) != nullptr;
+    }
+    if (const auto *list = container.TryAs<List>()) {
+        // Числа, строки, Bool и None не равны значениям других типов, а не приводят к ошибке
+        const bool is_hashable = IsHashable(item);
+        return std::any_of(
+            list->Items().begin(), list->Items().end(), [&](const ObjectHolder &element) {
+                if (is_hashable || IsHashable(element)) {
+                    return KeysEqual(item, element);
+                }
+                return Equal(item, element, context);
+            });
+    }
+    if (const auto *str = container.TryAs<String>()) {
+        const auto *substr = item.TryAs<String>();
+        if (!substr) {
+            throw RuntimeError("Only strings can be searched in a string"s);
+        }
+        return str->GetValue().View().find(substr->GetValue().View()) != std::string_view::npos;
+    }
+    throw RuntimeError("Object is not a container"s);
 }
 
 bool NotEqual(const ObjectHolder &lhs, const ObjectHolder &rhs, Context &context) {
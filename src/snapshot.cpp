@@ -0,0 +1,157 @@
+#include "snapshot.h"
+
+using namespace std;
+
+namespace runtime {
+
+namespace {
+
+// Возвращает true для значений, которые копия снимка должна копировать
+bool IsMutable(const ObjectHolder &value) {
+    return value.TryAs<List>() || value.TryAs<Dict>() || value.TryAs<ClassInstance>();
+}
+
+} // namespace
+
+Snapshot::Snapshot(unique_ptr<Executable> prelude, Context &context)
+    : prelude_(std::move(prelude)) {
+    prelude_->Execute(globals_, context);
+
+    unordered_set<const Object *> visited;
+    Closure immutable_globals;
+    for (const auto &binding : globals_) {
+        const ObjectHolder &value = binding.second;
+        Seal(value, visited);
+        if (IsMutable(value)) {
+            mutable_globals_.push_back(&binding);
+        } else {
+            immutable_globals.emplace(binding.first,
+                                      value ? ObjectHolder::Share(*value) : ObjectHolder::None());
+        }
+    }
+    immutable_globals_ = immutable_globals.Fork();
+}
+
+Snapshot::~Snapshot() {
+    // Поля экземпляров, элементы списков и пары словарей переносятся из всех объектов прежде,
+    // чем какой-либо из них освободится
+    vector<Closure> fields;
+    fields.reserve(instances_.size());
+    for (ClassInstance *instance : instances_) {
+        fields.push_back(std::move(instance->Fields()));
+        instance->Fields().clear();
+    }
+    vector<TrackedVector<ObjectHolder>> items;
+    items.reserve(lists_.size());
+    for (List *list : lists_) {
+        items.push_back(std::move(list->Items()));
+        list->Items().clear();
+    }
+    vector<TrackedVector<Dict::Entry>> entries;
+    entries.reserve(dicts_.size());
+    for (Dict *dict : dicts_) {
+        entries.push_back(dict->TakeItems());
+    }
+}
+
+void Snapshot::Seal(const ObjectHolder &value, unordered_set<const Object *> &visited) {
+    if (!value || !visited.insert(value.Get()).second) {
+        return;
+    }
+    if (const auto *str = value.TryAs<String>()) {
+        // Приведение к плоскому виду изменяет строку, поэтому выполняется до того, как строку
+        // увидят другие потоки
+        (void)str->GetValue();
+    } else if (const auto *cls = value.TryAs<Class>()) {
+        Seal(*cls, visited);
+    } else if (auto *instance = value.TryAs<ClassInstance>()) {
+        GarbageCollector::Instance().Detach(*instance);
+        instances_.push_back(instance);
+        Seal(instance->GetClass(), visited);
+        for (const auto &[name, field] : instance->Fields()) {
+            Seal(field, visited);
+        }
+    } else if (auto *list = value.TryAs<List>()) {
+        lists_.push_back(list);
+        for (const auto &item : list->Items()) {
+            Seal(item, visited);
+        }
+    } else if (auto *dict = value.TryAs<Dict>()) {
+        dicts_.push_back(dict);
+        for (const auto &entry : dict->Items()) {
+            Seal(entry.key, visited);
+            Seal(entry.value, visited);
+        }
+    }
+}
+
+void Snapshot::Seal(const Class &cls, unordered_set<const Object *> &visited) {
+    for (const Class *current = &cls; current; current = current->GetParent()) {
+        if (current != &cls && !visited.insert(current).second) {
+            return;
+        }
+        for (const auto &method : current->GetMethods()) {
+            if (method.cache) {
+                method.cache->Freeze();
+            }
+        }
+    }
+}
+
+Closure Snapshot::Fork() const {
+    // Копия таблицы без собственных переменных лишь разделяет её слой
+    Closure globals = immutable_globals_;
+    globals.reserve(mutable_globals_.size());
+    unordered_map<const Object *, ObjectHolder> copies;
+    for (const auto *binding : mutable_globals_) {
+        globals.emplace(binding->first, ForkValue(binding->second, copies));
+    }
+    return globals;
+}
+
+ObjectHolder Snapshot::ForkValue(const ObjectHolder &value,
+                                 unordered_map<const Object *, ObjectHolder> &copies) {
+    if (!value) {
+        return ObjectHolder::None();
+    }
+    if (!IsMutable(value)) {
+        // Неизменяемые значения и классы разделяются с снимком
+        return ObjectHolder::Share(*value);
+    }
+    if (const auto it = copies.find(value.Get()); it != copies.end()) {
+        return it->second;
+    }
+
+    // Копия запоминается до копирования элементов, чтобы циклы ссылались на неё же
+    if (const auto *list = value.TryAs<List>()) {
+        ObjectHolder copy = ObjectHolder::Own(List());
+        copies.emplace(list, copy);
+        auto &items = copy.TryAs<List>()->Items();
+        items.reserve(list->Size());
+        for (const auto &item : list->Items()) {
+            items.push_back(ForkValue(item, copies));
+        }
+        return copy;
+    }
+    if (const auto *dict = value.TryAs<Dict>()) {
+        ObjectHolder copy = ObjectHolder::Own(Dict());
+        copies.emplace(dict, copy);
+        auto &entries = *copy.TryAs<Dict>();
+        entries.Reserve(dict->Size());
+        for (const auto &entry : dict->Items()) {
+            entries.Set(ForkValue(entry.key, copies), ForkValue(entry.value, copies));
+        }
+        return copy;
+    }
+    const auto *instance = value.TryAs<ClassInstance>();
+    ObjectHolder copy = ObjectHolder::Own(ClassInstance(instance->GetClass()));
+    copies.emplace(instance, copy);
+    auto &fields = copy.TryAs<ClassInstance>()->Fields();
+    fields.reserve(instance->Fields().size());
+    for (const auto &[name, field] : instance->Fields()) {
+        fields.emplace(name, ForkValue(field, copies));
+    }
+    return copy;
+}
+
+} // namespace runtime
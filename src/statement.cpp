@@ -1,6 +1,12 @@
 #include "statement.h"
 
+#include <array>
+#include <charconv>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <optional>
 #include <sstream>
 
 using namespace std;
@@ -10,15 +16,145 @@ namespace ast {
 using runtime::Closure;
 using runtime::Context;
 using runtime::ObjectHolder;
+using NodeType = runtime::ExecutionStats::NodeType;
 
 namespace {
 const string ADD_METHOD = "__add__"s;
 const string INIT_METHOD = "__init__"s;
+const string SELF = "self"s;
+
+// Вычисляет фактические параметры вызова. Если их не больше INLINE_CAPACITY, значения
+// размещаются в буфере на стеке, и вызов метода обходится без выделения памяти
+class ArgumentBuffer {
+  public:
+    static constexpr size_t INLINE_CAPACITY = 8;
+
+    ArgumentBuffer(const std::vector<std::unique_ptr<Statement>> &args,
+                   Closure &closure,
+                   Context &context)
+        : size_(args.size()) {
+        ObjectHolder *values = inline_.data();
+        if (size_ > INLINE_CAPACITY) {
+            heap_.resize(size_);
+            values = heap_.data();
+        }
+        for (size_t i = 0; i < size_; ++i) {
+            values[i] = args[i]->Execute(closure, context);
+        }
+    }
+
+    operator runtime::ArgumentList() const { // NOLINT(google-explicit-constructor)
+        return {size_ > INLINE_CAPACITY ? heap_.data() : inline_.data(), size_};
+    }
+
+    // Переносит значения в values, заменяя их прежнее содержимое
+    void MoveTo(runtime::TrackedVector<ObjectHolder> &values) {
+        ObjectHolder *begin = size_ > INLINE_CAPACITY ? heap_.data() : inline_.data();
+        values.assign(std::make_move_iterator(begin), std::make_move_iterator(begin + size_));
+    }
+
+  private:
+    std::array<ObjectHolder, INLINE_CAPACITY> inline_;
+    runtime::TrackedVector<ObjectHolder> heap_;
+    size_t size_;
+};
+
+// Применяет арифметическую операцию к двум Number. Возвращает пустой ObjectHolder, если хотя
+// бы один из операндов не Number или checked_op сообщает о переполнении. Результат
+// записывается во временный левый операнд, если им больше никто не владеет
+template <typename CheckedOp>
+ObjectHolder SmallIntegerArithmetic(const ObjectHolder &lhs,
+                                    const ObjectHolder &rhs,
+                                    CheckedOp checked_op) {
+    auto *lhs_number = lhs.TryAs<runtime::Number>();
+    if (!lhs_number) {
+        return {};
+    }
+    const auto *rhs_number = rhs.TryAs<runtime::Number>();
+    std::int64_t result;
+    if (!rhs_number || checked_op(lhs_number->GetValue(), rhs_number->GetValue(), &result)) {
+        return {};
+    }
+    if (lhs.IsSoleOwner()) {
+        lhs_number->SetValue(result);
+        return lhs;
+    }
+    return ObjectHolder::Own(runtime::Number(result));
+}
+
+// Применяет арифметическую операцию к целым числам произвольной длины. Возвращает пустой
+// ObjectHolder, если хотя бы один из операндов не является целым числом
+template <typename BigOp>
+ObjectHolder BigIntegerArithmetic(const ObjectHolder &lhs, const ObjectHolder &rhs, BigOp big_op) {
+    if (!runtime::IsInteger(lhs) || !runtime::IsInteger(rhs)) {
+        return {};
+    }
+    return runtime::MakeInteger(big_op(runtime::ToBigInt(lhs), runtime::ToBigInt(rhs)));
+}
+
+// Возвращает значение индекса списка
+long long GetIndex(const ObjectHolder &index) {
+    const auto *number = index.TryAs<runtime::Number>();
+    if (!number) {
+        throw runtime::RuntimeError("List indices must be numbers"s);
+    }
+    return number->GetValue();
+}
+
+runtime::List &GetList(const ObjectHolder &object) {
+    auto *list = object.TryAs<runtime::List>();
+    if (!list) {
+        throw runtime::RuntimeError("Object is not a list"s);
+    }
+    return *list;
+}
+
+// Строки с представлениями значений None, True и False. Копирование короткой SharedString
+// не выделяет памяти, поэтому str() для этих значений обходится без аллокаций
+const runtime::SharedString NONE_STRING{"None"sv};
+const runtime::SharedString TRUE_STRING{"True"sv};
+const runtime::SharedString FALSE_STRING{"False"sv};
+
+// Преобразует значение в строку так же, как его вывела бы команда print. Строки неизменяемы:
+// принадлежащая программе строка возвращается как есть, а у строки-константы разделяется
+// буфер. Числа форматируются без ostringstream, а метод __str__ ищется в классе один раз
+// при его создании
+ObjectHolder ToString(const ObjectHolder &obj, Context &context) {
+    if (!obj) {
+        return ObjectHolder::Own(runtime::String(NONE_STRING));
+    }
+    if (const auto *str = obj.TryAs<runtime::String>()) {
+        return obj.IsOwner() ? obj : ObjectHolder::Own(runtime::String(str->GetValue()));
+    }
+    if (const auto *number = obj.TryAs<runtime::Number>()) {
+        std::array<char, 24> buffer{};
+        const auto [end, ec] =
+            std::to_chars(buffer.data(), buffer.data() + buffer.size(), number->GetValue());
+        return ObjectHolder::Own(
+            runtime::String(std::string_view(buffer.data(), end - buffer.data())));
+    }
+    if (const auto *boolean = obj.TryAs<runtime::Bool>()) {
+        return ObjectHolder::Own(runtime::String(boolean->GetValue() ? TRUE_STRING : FALSE_STRING));
+    }
+    if (const auto *number = obj.TryAs<runtime::BigNumber>()) {
+        return ObjectHolder::Own(runtime::String(number->GetValue().ToString()));
+    }
+    if (auto *instance = obj.TryAs<runtime::ClassInstance>()) {
+        if (const runtime::Method *str_method = instance->GetClass().GetStrMethod()) {
+            return ToString(instance->Call(*str_method, {}, context), context);
+        }
+    }
+
+    std::ostringstream out;
+    obj->Print(out, context);
+    return ObjectHolder::Own(runtime::String(out.str()));
+}
 } // namespace
 
-ObjectHolder VariableValue::Execute(Closure &closure, Context & /*context*/) {
+ObjectHolder VariableValue::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::VariableValue);
     if (dotted_ids_.empty()) {
-        throw std::runtime_error("Dotted ids cannot by empty"s);
+        throw runtime::RuntimeError("Dotted ids cannot by empty"s);
     }
 
     if (const auto it = closure.find(dotted_ids_[0]); it != closure.end()) {
@@ -33,7 +169,7 @@ ObjectHolder VariableValue::Execute(Closure &closure, Context & /*context*/) {
                         continue;
                     }
                 }
-                throw std::runtime_error("Cannot find class"s);
+                throw runtime::RuntimeError("Cannot find class"s);
             }
             const auto &fields = obj.TryAs<runtime::ClassInstance>()->Fields();
             if (const auto it = fields.find(dotted_ids_.back()); it != fields.end()) {
@@ -44,15 +180,19 @@ ObjectHolder VariableValue::Execute(Closure &closure, Context & /*context*/) {
             return obj;
         }
     }
-    throw std::runtime_error("Cannot find class"s);
+    throw runtime::RuntimeError("Cannot find class"s);
 }
 
 ObjectHolder Assignment::Execute(Closure &closure, Context &context) {
-    closure[var_] = rv_->Execute(closure, context);
-    return closure.at(var_);
+    context.GetStats().CountNode(NodeType::Assignment);
+    ObjectHolder value = rv_->Execute(closure, context);
+    ObjectHolder &variable = runtime::GetOrInsert(closure, var_, context);
+    variable = std::move(value);
+    return variable;
 }
 
 ObjectHolder Print::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Print);
     std::string delim{};
     for (const auto &arg : args_) {
         const ObjectHolder value = arg->Execute(closure, context);
@@ -69,33 +209,135 @@ ObjectHolder Print::Execute(Closure &closure, Context &context) {
     return ObjectHolder::None();
 }
 
+MethodCall::MethodCall(std::unique_ptr<Statement> object,
+                       std::string method,
+                       std::vector<std::unique_ptr<Statement>> args)
+    : object_(std::move(object)), method_(std::move(method)), args_(std::move(args)) {
+    const auto *variable = dynamic_cast<const VariableValue *>(object_.get());
+    self_call_ = variable && variable->GetDottedIds() == std::vector{SELF};
+}
+
 ObjectHolder MethodCall::Execute(Closure &closure, Context &context) {
-    std::vector<runtime::ObjectHolder> object_args;
-    for (const auto &arg : args_) {
-        object_args.push_back(arg->Execute(closure, context));
-    }
+    context.GetStats().CountNode(NodeType::MethodCall);
+    const ArgumentBuffer object_args(args_, closure, context);
 
-    auto *cls = object_->Execute(closure, context).TryAs<runtime::ClassInstance>();
+    const ObjectHolder object = object_->Execute(closure, context);
+    if (auto *list = object.TryAs<runtime::List>()) {
+        return list->Call(method_, object_args, context);
+    }
+    auto *cls = object.TryAs<runtime::ClassInstance>();
     if (!cls) {
-        throw std::runtime_error("Cannot find class"s);
+        throw runtime::RuntimeError("Cannot find class"s);
     }
 
     return cls->Call(method_, object_args, context);
 }
 
+void MethodCall::ScheduleTailCall(Closure &closure, Context &context) {
+    // Параметры вычисляются в собственный буфер: вычисление параметра может само выполнить
+    // хвостовой вызов и занять tail_args
+    ArgumentBuffer tail_args(args_, closure, context);
+    auto &state = context.GetReturnState();
+
+    const ObjectHolder object = object_->Execute(closure, context);
+    if (auto *list = object.TryAs<runtime::List>()) {
+        // self переназначен на список: встроенный метод выполняется сразу
+        state.value = list->Call(method_, tail_args, context);
+        state.active = true;
+        return;
+    }
+    auto *cls = object.TryAs<runtime::ClassInstance>();
+    if (!cls) {
+        throw runtime::RuntimeError("Cannot find class"s);
+    }
+
+    tail_args.MoveTo(state.tail_args);
+    state.tail_self = cls;
+    state.tail_method = &method_;
+    state.active = true;
+}
+
 ObjectHolder Stringify::Execute(Closure &closure, Context &context) {
-    std::ostringstream out;
+    context.GetStats().CountNode(NodeType::Stringify);
+    return ToString(arg_->Execute(closure, context), context);
+}
+
+ObjectHolder Length::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Length);
     const ObjectHolder obj = arg_->Execute(closure, context);
+    if (const auto *list = obj.TryAs<runtime::List>()) {
+        return ObjectHolder::Own(runtime::Number(static_cast<std::int64_t>(list->Size())));
+    }
+    if (const auto *dict = obj.TryAs<runtime::Dict>()) {
+        return ObjectHolder::Own(runtime::Number(static_cast<std::int64_t>(dict->Size())));
+    }
+    if (const auto *str = obj.TryAs<runtime::String>()) {
+        return ObjectHolder::Own(runtime::Number(static_cast<std::int64_t>(str->Size())));
+    }
+    throw runtime::RuntimeError("Object has no len()"s);
+}
 
-    if (obj) {
-        obj->Print(out, context);
-    } else {
-        out << "None"s;
+ObjectHolder ListLiteral::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::ListLiteral);
+    runtime::TrackedVector<ObjectHolder> items;
+    items.reserve(items_.size());
+    for (const auto &item : items_) {
+        items.push_back(item->Execute(closure, context));
     }
-    return ObjectHolder::Own(runtime::String(out.str()));
+    return ObjectHolder::Own(runtime::List(std::move(items)));
+}
+
+ObjectHolder DictLiteral::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::DictLiteral);
+    runtime::Dict dict;
+    dict.Reserve(items_.size());
+    for (const auto &[key, value] : items_) {
+        ObjectHolder key_value = key->Execute(closure, context);
+        dict.Set(key_value, value->Execute(closure, context));
+    }
+    return ObjectHolder::Own(std::move(dict));
+}
+
+ObjectHolder Index::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Index);
+    const ObjectHolder object = object_->Execute(closure, context);
+    const ObjectHolder index = index_->Execute(closure, context);
+    if (auto *dict = object.TryAs<runtime::Dict>()) {
+        return dict->At(index);
+    }
+    return GetList(object).At(GetIndex(index));
+}
+
+ObjectHolder Slice::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Slice);
+    const ObjectHolder object = object_->Execute(closure, context);
+    const auto &list = GetList(object);
+    std::optional<long long> start, stop;
+    if (start_) {
+        start = GetIndex(start_->Execute(closure, context));
+    }
+    if (stop_) {
+        stop = GetIndex(stop_->Execute(closure, context));
+    }
+    return ObjectHolder::Own(list.Slice(start, stop));
+}
+
+ObjectHolder IndexAssignment::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::IndexAssignment);
+    const ObjectHolder object = object_->Execute(closure, context);
+    const ObjectHolder index = index_->Execute(closure, context);
+    ObjectHolder value = rv_->Execute(closure, context);
+    if (auto *dict = object.TryAs<runtime::Dict>()) {
+        return dict->Set(index, std::move(value));
+    }
+    // Вычисление rv могло изменить размер списка, поэтому элемент ищется после него
+    ObjectHolder &item = GetList(object).At(GetIndex(index));
+    item = std::move(value);
+    return item;
 }
 
 ObjectHolder Add::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Add);
     auto obj_lhs = lhs_->Execute(closure, context);
     auto obj_rhs = rhs_->Execute(closure, context);
 
@@ -103,90 +345,166 @@ ObjectHolder Add::Execute(Closure &closure, Context &context) {
         return lhs_inst->Call(ADD_METHOD, {obj_rhs}, context);
     }
 
-    if (obj_lhs.TryAs<runtime::Number>() && obj_rhs.TryAs<runtime::Number>()) {
-        return ObjectHolder::Own(
-            runtime::Number(obj_lhs.TryAs<runtime::Number>()->GetValue() +
-                            obj_rhs.TryAs<runtime::Number>()->GetValue()));
+    auto add = [](std::int64_t lhs, std::int64_t rhs, std::int64_t *result) {
+        return __builtin_add_overflow(lhs, rhs, result);
+    };
+    if (auto sum = SmallIntegerArithmetic(obj_lhs, obj_rhs, add)) {
+        return sum;
     }
 
     if (obj_lhs.TryAs<runtime::String>() && obj_rhs.TryAs<runtime::String>()) {
-        return ObjectHolder::Own(
-            runtime::String(obj_lhs.TryAs<runtime::String>()->GetValue() +
-                            obj_rhs.TryAs<runtime::String>()->GetValue()));
+        return runtime::String::Concat(obj_lhs, obj_rhs);
+    }
+
+    if (obj_lhs.TryAs<runtime::List>() && obj_rhs.TryAs<runtime::List>()) {
+        const auto &lhs_items = obj_lhs.TryAs<runtime::List>()->Items();
+        const auto &rhs_items = obj_rhs.TryAs<runtime::List>()->Items();
+        runtime::TrackedVector<ObjectHolder> items;
+        items.reserve(lhs_items.size() + rhs_items.size());
+        items.insert(items.end(), lhs_items.begin(), lhs_items.end());
+        items.insert(items.end(), rhs_items.begin(), rhs_items.end());
+        return ObjectHolder::Own(runtime::List(std::move(items)));
+    }
+
+    // Переполнение 64 бит или сложение длинных чисел
+    if (auto sum = BigIntegerArithmetic(obj_lhs, obj_rhs, std::plus<>())) {
+        return sum;
     }
 
-    throw std::runtime_error("Cannot sum objects"s);
+    throw runtime::RuntimeError("Cannot sum objects"s);
 }
 
 ObjectHolder Sub::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Sub);
     auto obj_lhs = lhs_->Execute(closure, context);
     auto obj_rhs = rhs_->Execute(closure, context);
 
-    if (obj_lhs.TryAs<runtime::Number>() && obj_rhs.TryAs<runtime::Number>()) {
-        return ObjectHolder::Own(
-            runtime::Number(obj_lhs.TryAs<runtime::Number>()->GetValue() -
-                            obj_rhs.TryAs<runtime::Number>()->GetValue()));
+    auto sub = [](std::int64_t lhs, std::int64_t rhs, std::int64_t *result) {
+        return __builtin_sub_overflow(lhs, rhs, result);
+    };
+    if (auto difference = SmallIntegerArithmetic(obj_lhs, obj_rhs, sub)) {
+        return difference;
+    }
+    if (auto difference = BigIntegerArithmetic(obj_lhs, obj_rhs, std::minus<>())) {
+        return difference;
     }
 
-    throw std::runtime_error("Cannot sub objects"s);
+    throw runtime::RuntimeError("Cannot sub objects"s);
 }
 
 ObjectHolder Mult::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Mult);
     auto obj_lhs = lhs_->Execute(closure, context);
     auto obj_rhs = rhs_->Execute(closure, context);
 
-    if (obj_lhs.TryAs<runtime::Number>() && obj_rhs.TryAs<runtime::Number>()) {
-        return ObjectHolder::Own(
-            runtime::Number(obj_lhs.TryAs<runtime::Number>()->GetValue() *
-                            obj_rhs.TryAs<runtime::Number>()->GetValue()));
+    auto mult = [](std::int64_t lhs, std::int64_t rhs, std::int64_t *result) {
+        return __builtin_mul_overflow(lhs, rhs, result);
+    };
+    if (auto product = SmallIntegerArithmetic(obj_lhs, obj_rhs, mult)) {
+        return product;
+    }
+    if (auto product = BigIntegerArithmetic(obj_lhs, obj_rhs, std::multiplies<>())) {
+        return product;
     }
 
-    throw std::runtime_error("Cannot multiply objects"s);
+    throw runtime::RuntimeError("Cannot multiply objects"s);
 }
 
 ObjectHolder Div::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Div);
     auto obj_lhs = lhs_->Execute(closure, context);
     auto obj_rhs = rhs_->Execute(closure, context);
 
-    if (obj_lhs.TryAs<runtime::Number>() && obj_rhs.TryAs<runtime::Number>()) {
-        if (obj_rhs.TryAs<runtime::Number>()->GetValue() == 0) {
-            throw std::runtime_error("division by zero"s);
+    auto div = [](std::int64_t lhs, std::int64_t rhs, std::int64_t *result) {
+        if (rhs == 0) {
+            throw runtime::RuntimeError("division by zero"s);
         }
-        return ObjectHolder::Own(
-            runtime::Number(obj_lhs.TryAs<runtime::Number>()->GetValue() /
-                            obj_rhs.TryAs<runtime::Number>()->GetValue()));
+        // Единственное переполнение: минимальное значение, делённое на -1
+        if (rhs == -1 && lhs == std::numeric_limits<std::int64_t>::min()) {
+            return true;
+        }
+        *result = lhs / rhs;
+        return false;
+    };
+    if (auto quotient = SmallIntegerArithmetic(obj_lhs, obj_rhs, div)) {
+        return quotient;
+    }
+    auto big_div = [](const runtime::BigInt &lhs, const runtime::BigInt &rhs) {
+        if (rhs.IsZero()) {
+            throw runtime::RuntimeError("division by zero"s);
+        }
+        return lhs / rhs;
+    };
+    if (auto quotient = BigIntegerArithmetic(obj_lhs, obj_rhs, big_div)) {
+        return quotient;
     }
 
-    throw std::runtime_error("Cannot division objects"s);
+    throw runtime::RuntimeError("Cannot division objects"s);
 }
 
 ObjectHolder Compound::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Compound);
+    const auto &state = context.GetReturnState();
+    auto &calls = runtime::CallStack::Instance();
     for (const auto &statement : statements_) {
+        calls.SetLine(statement->GetLine());
         statement->Execute(closure, context);
+        if (state.active) {
+            break;
+        }
     }
     return {};
 }
 
+Return::Return(std::unique_ptr<Statement> statement) : statement_(std::move(statement)) {
+    auto *call = dynamic_cast<MethodCall *>(statement_.get());
+    if (call && call->IsSelfCall()) {
+        tail_call_ = call;
+    }
+}
+
 ObjectHolder Return::Execute(Closure &closure, Context &context) {
-    throw statement_->Execute(closure, context);
+    context.GetStats().CountNode(NodeType::Return);
+    auto &state = context.GetReturnState();
+    if (tail_call_ && state.frame == &closure) {
+        tail_call_->ScheduleTailCall(closure, context);
+        return {};
+    }
+
+    state.value = statement_->Execute(closure, context);
+    state.active = true;
+    return {};
 }
 
-ObjectHolder ClassDefinition::Execute(Closure &closure, Context & /*context*/) {
-    closure[class_.TryAs<runtime::Class>()->GetName()] = class_;
+ObjectHolder ClassDefinition::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::ClassDefinition);
+    runtime::GetOrInsert(closure, class_.TryAs<runtime::Class>()->GetName(), context) = class_;
     return class_;
 }
 
+ObjectHolder Import::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Import);
+    for (const auto &[name, value] : module_->Fork()) {
+        runtime::GetOrInsert(closure, name, context) = value;
+    }
+    return ObjectHolder::None();
+}
+
 ObjectHolder FieldAssignment::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::FieldAssignment);
     auto *cls = object_.Execute(closure, context).TryAs<runtime::ClassInstance>();
     if (!cls) {
-        throw std::runtime_error("Cannot find class"s);
+        throw runtime::RuntimeError("Cannot find class"s);
     }
 
-    cls->Fields()[field_name_] = rv_->Execute(closure, context);
-    return cls->Fields()[field_name_];
+    ObjectHolder value = rv_->Execute(closure, context);
+    ObjectHolder &field = runtime::GetOrInsert(cls->Fields(), field_name_, context);
+    field = std::move(value);
+    return field;
 }
 
 ObjectHolder IfElse::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::IfElse);
     if (runtime::IsTrue(condition_->Execute(closure, context))) {
         return if_body_->Execute(closure, context);
     }
@@ -197,45 +515,157 @@ ObjectHolder IfElse::Execute(Closure &closure, Context &context) {
     return {};
 }
 
+ObjectHolder While::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::While);
+    const auto &state = context.GetReturnState();
+    while (runtime::IsTrue(condition_->Execute(closure, context))) {
+        context.CountStep();
+        body_->Execute(closure, context);
+        if (state.active) {
+            break;
+        }
+    }
+    return {};
+}
+
+ForRange::ForRange(std::string var,
+                   std::int64_t start,
+                   std::int64_t stop,
+                   std::int64_t step,
+                   std::unique_ptr<Statement> body)
+    : var_(std::move(var)), start_(start), stop_(stop), step_(step), body_(std::move(body)) {}
+
+ForRange::ForRange(std::string var,
+                   std::unique_ptr<Statement> start,
+                   std::unique_ptr<Statement> stop,
+                   std::unique_ptr<Statement> step,
+                   std::unique_ptr<Statement> body)
+    : var_(std::move(var)), start_expr_(std::move(start)), stop_expr_(std::move(stop)),
+      step_expr_(std::move(step)), body_(std::move(body)) {}
+
+ObjectHolder ForRange::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::ForRange);
+    std::int64_t start = start_, stop = stop_, step = step_;
+    if (start_expr_) {
+        auto evaluate = [&closure, &context](const std::unique_ptr<Statement> &expr) {
+            const ObjectHolder value = expr->Execute(closure, context);
+            const auto *number = value.TryAs<runtime::Number>();
+            if (!number) {
+                throw runtime::RuntimeError("range() arguments must be numbers"s);
+            }
+            return number->GetValue();
+        };
+        start = evaluate(start_expr_);
+        stop = evaluate(stop_expr_);
+        step = step_expr_ ? evaluate(step_expr_) : 1;
+        if (step == 0) {
+            throw runtime::RuntimeError("range() step cannot be zero"s);
+        }
+    }
+
+    const auto &state = context.GetReturnState();
+    ObjectHolder *counter = nullptr;
+    for (std::int64_t i = start; step > 0 ? i < stop : i > stop;) {
+        if (!counter) {
+            counter = &runtime::GetOrInsert(closure, var_, context);
+        }
+        // Тело цикла могло сохранить число в другой переменной, тогда создаётся новое
+        auto *number = counter->TryAs<runtime::Number>();
+        if (number && counter->IsSoleOwner()) {
+            number->SetValue(i);
+        } else {
+            *counter = ObjectHolder::Own(runtime::Number(i));
+        }
+
+        context.CountStep();
+        body_->Execute(closure, context);
+        // Счётчик, который вышел бы за пределы int64, уже прошёл stop
+        if (state.active || __builtin_add_overflow(i, step, &i)) {
+            break;
+        }
+    }
+    return {};
+}
+
+ObjectHolder ForEach::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::ForEach);
+    // Контейнер удерживается до конца цикла, даже если тело переназначит переменную с ним
+    const ObjectHolder iterable = iterable_->Execute(closure, context);
+
+    const auto &state = context.GetReturnState();
+    ObjectHolder *variable = nullptr;
+    auto iterate = [&](const auto &items, auto get_value) {
+        // Тело цикла может добавлять элементы, поэтому размер проверяется на каждом шаге
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (!variable) {
+                variable = &runtime::GetOrInsert(closure, var_, context);
+            }
+            *variable = get_value(items[i]);
+
+            context.CountStep();
+            body_->Execute(closure, context);
+            if (state.active) {
+                break;
+            }
+        }
+    };
+
+    if (const auto *dict = iterable.TryAs<runtime::Dict>()) {
+        iterate(dict->Items(), [](const runtime::Dict::Entry &entry) { return entry.key; });
+    } else if (const auto *list = iterable.TryAs<runtime::List>()) {
+        iterate(list->Items(), [](const ObjectHolder &item) { return item; });
+    } else {
+        throw runtime::RuntimeError("Object is not iterable"s);
+    }
+    return {};
+}
+
 ObjectHolder Or::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Or);
     return ObjectHolder::Own(runtime::Bool(runtime::IsTrue(lhs_->Execute(closure, context)) ||
                                            runtime::IsTrue(rhs_->Execute(closure, context))));
 }
 
 ObjectHolder And::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::And);
     return ObjectHolder::Own(runtime::Bool(runtime::IsTrue(lhs_->Execute(closure, context)) &&
                                            runtime::IsTrue(rhs_->Execute(closure, context))));
 }
 
 ObjectHolder Not::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Not);
     return ObjectHolder::Own(runtime::Bool(!runtime::IsTrue(arg_->Execute(closure, context))));
 }
 
 ObjectHolder Comparison::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::Comparison);
     return ObjectHolder::Own(runtime::Bool(
         cmp_(lhs_->Execute(closure, context), rhs_->Execute(closure, context), context)));
 }
 
 ObjectHolder NewInstance::Execute(Closure &closure, Context &context) {
+    context.GetStats().CountNode(NodeType::NewInstance);
     ObjectHolder obj = ObjectHolder::Own(runtime::ClassInstance(class_));
     auto new_instance = obj.TryAs<runtime::ClassInstance>();
     if (new_instance && new_instance->HasMethod(INIT_METHOD, args_.size())) {
-        std::vector<runtime::ObjectHolder> new_args;
-        for (const auto &arg : args_) {
-            new_args.push_back(arg->Execute(closure, context));
-        }
+        const ArgumentBuffer new_args(args_, closure, context);
         new_instance->Call(INIT_METHOD, new_args, context);
     }
+    runtime::GarbageCollector::Instance().MaybeCollect();
     return obj;
 }
 
 ObjectHolder MethodBody::Execute(Closure &closure, Context &context) {
-    ObjectHolder result = ObjectHolder::None();
-
-    try {
-        result = body_->Execute(closure, context);
-    } catch (ObjectHolder &obj) { result = std::move(obj); }
-
+    context.GetStats().CountNode(NodeType::MethodBody);
+    ObjectHolder result = body_->Execute(closure, context);
+
+    // Результат инструкции return забирает тело метода, а хвостовой вызов остаётся
+    // незавершённым до возврата в ClassInstance::Call
+    auto &state = context.GetReturnState();
+    if (state.active && !state.tail_method) {
+        state.active = false;
+        return std::move(state.value);
+    }
     return result;
 }
 
@@ -0,0 +1,146 @@
+#include "bigint.h"
+#include "test_runner.h"
+
+#include <limits>
+
+using namespace std;
+
+namespace runtime {
+
+namespace {
+
+// Строит число по десятичной записи
+BigInt FromString(const string &digits) {
+    BigInt result;
+    const bool negative = !digits.empty() && digits[0] == '-';
+    for (size_t i = negative ? 1 : 0; i < digits.size(); ++i) {
+        result = result * 10 + (digits[i] - '0');
+    }
+    return negative ? -result : result;
+}
+
+// Возвращает base в степени exponent
+BigInt Power(const BigInt &base, int exponent) {
+    BigInt result = 1;
+    for (int i = 0; i < exponent; ++i) {
+        result = result * base;
+    }
+    return result;
+}
+
+void TestBigIntConversions() {
+    constexpr auto MIN = numeric_limits<int64_t>::min();
+    constexpr auto MAX = numeric_limits<int64_t>::max();
+
+    for (const int64_t value : {int64_t{0}, int64_t{1}, int64_t{-1}, int64_t{4294967296}, MIN, MAX}) {
+        const BigInt number = value;
+        ASSERT(number.FitsInt64());
+        ASSERT_EQUAL(number.ToInt64(), value);
+        ASSERT_EQUAL(number.ToString(), to_string(value));
+    }
+    ASSERT(BigInt(0).IsZero());
+    ASSERT(!BigInt(0).IsNegative());
+    ASSERT(BigInt(-5).IsNegative());
+
+    ASSERT(!(BigInt(MAX) + 1).FitsInt64());
+    ASSERT((BigInt(MIN) + 0).FitsInt64());
+    ASSERT(!(BigInt(MIN) - 1).FitsInt64());
+    ASSERT_EQUAL((BigInt(MAX) + 1).ToString(), "9223372036854775808"s);
+    ASSERT_EQUAL((BigInt(MIN) - 1).ToString(), "-9223372036854775809"s);
+    ASSERT_EQUAL((-BigInt(MIN)).ToString(), "9223372036854775808"s);
+
+    const string digits = "-123456789012345678901234567890000000001"s;
+    ASSERT_EQUAL(FromString(digits).ToString(), digits);
+
+    for (const string &decimal : {"0"s, "7"s, "000042"s, "123456789"s, "1234567890"s,
+                                 "9223372036854775808"s, "1180591620717411303424"s,
+                                 "123456789012345678901234567890000000001"s}) {
+        ASSERT(BigInt::FromDecimal(decimal) == FromString(decimal));
+    }
+    ASSERT(BigInt::FromDecimal("9223372036854775807"s).FitsInt64());
+    ASSERT(!BigInt::FromDecimal("9223372036854775808"s).FitsInt64());
+}
+
+void TestBigIntArithmetic() {
+    const BigInt two_64 = BigInt(4294967296) * BigInt(4294967296);
+    ASSERT_EQUAL(two_64.ToString(), "18446744073709551616"s);
+    ASSERT_EQUAL((two_64 - 1).ToString(), "18446744073709551615"s);
+    ASSERT_EQUAL((1 - two_64).ToString(), "-18446744073709551615"s);
+    ASSERT((two_64 - two_64).IsZero());
+    ASSERT(!(two_64 - two_64).IsNegative());
+    ASSERT_EQUAL((two_64 * -3).ToString(), "-55340232221128654848"s);
+
+    ASSERT(BigInt(-1) < BigInt(0));
+    ASSERT(-two_64 < BigInt(numeric_limits<int64_t>::min()));
+    ASSERT(BigInt(numeric_limits<int64_t>::max()) < two_64);
+    ASSERT_EQUAL(BigInt::Compare(two_64, two_64), 0);
+    ASSERT(two_64 == FromString("18446744073709551616"s));
+    ASSERT(two_64 != -two_64);
+    ASSERT_EQUAL(two_64.Hash(), FromString("18446744073709551616"s).Hash());
+}
+
+void TestBigIntKaratsuba() {
+    // Множители по 100 с лишним разрядов перемножаются алгоритмом Карацубы
+    const BigInt ten_1000 = Power(10, 1000);
+    ASSERT_EQUAL((ten_1000 * ten_1000).ToString(), "1"s + string(2000, '0'));
+
+    // (10^n - 1)^2 = 10^2n - 2 * 10^n + 1 = 99...9800...01
+    const BigInt nines = ten_1000 - 1;
+    ASSERT_EQUAL((nines * nines).ToString(), string(999, '9') + "8"s + string(999, '0') + "1"s);
+
+    // Множители разной длины
+    const BigInt three_200 = Power(3, 200);
+    ASSERT(ten_1000 * three_200 == three_200 * ten_1000);
+    ASSERT((ten_1000 * -three_200) / three_200 == -ten_1000);
+
+    // Псевдослучайные числа длиной от 1 до 150 разрядов
+    uint64_t seed = 42;
+    auto random_number = [&seed](int limbs) {
+        BigInt result;
+        for (int i = 0; i < limbs; ++i) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            result = result * 4294967296 + static_cast<int64_t>(seed >> 32);
+        }
+        return result;
+    };
+    for (const int size : {1, 20, 31, 32, 33, 64, 100, 150}) {
+        const BigInt a = random_number(size) + 1;
+        const BigInt b = random_number(150 - size) + 1;
+        const BigInt product = a * b;
+        ASSERT(product == b * a);
+        ASSERT(product / a == b);
+        ASSERT(product / b == a);
+        ASSERT((a + b) * (a - b) == a * a - b * b);
+    }
+}
+
+void TestBigIntDivision() {
+    ASSERT_EQUAL((BigInt(7) / BigInt(2)).ToInt64(), 3);
+    ASSERT_EQUAL((BigInt(-7) / BigInt(2)).ToInt64(), -3);
+    ASSERT_EQUAL((BigInt(7) / BigInt(-2)).ToInt64(), -3);
+    ASSERT((BigInt(3) / Power(10, 30)).IsZero());
+    ASSERT_THROWS(BigInt(1) / BigInt(0), std::runtime_error);
+
+    // Делители из нескольких разрядов, в том числе с установленным старшим битом
+    const BigInt dividend = Power(7, 300) + 12345;
+    for (const BigInt &divisor :
+         {Power(2, 64) - 1, Power(2, 64), Power(3, 50), -Power(11, 97) + 5, Power(2, 95)}) {
+        const BigInt quotient = dividend / divisor;
+        const BigInt remainder = dividend - quotient * divisor;
+        const BigInt magnitude = divisor.IsNegative() ? -divisor : divisor;
+        ASSERT(!remainder.IsNegative());
+        ASSERT(remainder < magnitude);
+    }
+    ASSERT(Power(10, 500) / Power(10, 250) == Power(10, 250));
+}
+
+} // namespace
+
+void RunBigIntTests(TestRunner &tr) {
+    RUN_TEST(tr, runtime::TestBigIntConversions);
+    RUN_TEST(tr, runtime::TestBigIntArithmetic);
+    RUN_TEST(tr, runtime::TestBigIntKaratsuba);
+    RUN_TEST(tr, runtime::TestBigIntDivision);
+}
+
+} // namespace runtime
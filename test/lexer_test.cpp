@@ -40,6 +40,17 @@ void TestKeywords() {
     ASSERT_EQUAL(lexer.NextToken(), Token(token_type::False{}));
 }
 
+void TestLoopKeywords() {
+    istringstream input("while whiles for in range"s);
+    Lexer lexer(input);
+
+    ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::While{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{"whiles"s}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::For{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::In{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{"range"s}));
+}
+
 void TestNumbers() {
     istringstream input("42 15 -53"s);
     Lexer lexer(input);
@@ -49,6 +60,35 @@ void TestNumbers() {
     // Отрицательные числа формируются на этапе синтаксического анализа
     ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{'-'}));
     ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Number{53}));
+
+    // Числа, не умещающиеся в 64 бита, остаются десятичной записью
+    istringstream long_input("9223372036854775807 9223372036854775808 1180591620717411303424"s);
+    Lexer long_lexer(long_input);
+    ASSERT_EQUAL(long_lexer.CurrentToken(), Token(token_type::Number{9223372036854775807}));
+    ASSERT_EQUAL(long_lexer.NextToken(), Token(token_type::BigNumber{"9223372036854775808"s}));
+    ASSERT_EQUAL(long_lexer.NextToken(), Token(token_type::BigNumber{"1180591620717411303424"s}));
+    ASSERT_EQUAL(long_lexer.NextToken(), Token(token_type::Newline{}));
+}
+
+void TestLineNumbers() {
+    istringstream input("x = 1\n\n\n# note\ny = 'a' # tail\nprint y\n"s);
+    Lexer lexer(input);
+
+    ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{"x"s}));
+    ASSERT_EQUAL(lexer.CurrentLine(), 1u);
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{'='}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Number{1}));
+    ASSERT_EQUAL(lexer.CurrentLine(), 1u);
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+
+    // Пустые строки и комментарии учитываются в нумерации
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{"y"s}));
+    ASSERT_EQUAL(lexer.CurrentLine(), 5u);
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{'='}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::String{"a"s}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Print{}));
+    ASSERT_EQUAL(lexer.CurrentLine(), 6u);
 }
 
 void TestIds() {
@@ -194,6 +234,83 @@ x = 1
     ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
 }
 
+void TestDedentsAtEndOfInput() {
+    istringstream input("class A:\n  def f():\n    return 1\n"s);
+    Lexer lexer(input);
+
+    ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Class{}));
+    for (int i = 0; i < 3; ++i) {
+        lexer.NextToken();
+    }
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Indent{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Def{}));
+    for (int i = 0; i < 5; ++i) {
+        lexer.NextToken();
+    }
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Indent{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Return{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Number{1}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Dedent{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Dedent{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
+}
+
+// Строки из пробелов и комментариев не меняют отступ, где бы ни начинался комментарий
+void TestCommentsInBlocks() {
+    istringstream input("class A:\n"
+                        "  # c1\n"
+                        "  def f():\n"
+                        "    x = 1  \n"
+                        "# c2\n"
+                        "      # c3\n"
+                        "    \n"
+                        "    return x # c4\n"
+                        "# c5\n"
+                        "y = 2 # c6"s);
+    Lexer lexer(input);
+
+    ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Class{}));
+    for (int i = 0; i < 3; ++i) {
+        lexer.NextToken();
+    }
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Indent{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Def{}));
+    for (int i = 0; i < 5; ++i) {
+        lexer.NextToken();
+    }
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Indent{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{"x"s}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{'='}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Number{1}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Return{}));
+    ASSERT_EQUAL(lexer.CurrentLine(), 8u);
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{"x"s}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Dedent{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Dedent{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{"y"s}));
+    ASSERT_EQUAL(lexer.CurrentLine(), 10u);
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{'='}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Number{2}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
+}
+
+// Лексер части программы нумерует строки с номера её первой строки
+void TestFirstLine() {
+    istringstream input("\nx\n  y\n"s);
+    Lexer lexer(input, 40);
+    ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{"x"s}));
+    ASSERT_EQUAL(lexer.CurrentLine(), 41u);
+    lexer.NextToken();
+    lexer.NextToken();
+    ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{"y"s}));
+    ASSERT_EQUAL(lexer.CurrentLine(), 42u);
+}
+
 void TestMythonProgram() {
     istringstream input(R"(
 x = 4
@@ -377,17 +494,22 @@ abc#
 void RunOpenLexerTests(TestRunner &tr) {
     RUN_TEST(tr, parse::TestSimpleAssignment);
     RUN_TEST(tr, parse::TestKeywords);
+    RUN_TEST(tr, parse::TestLoopKeywords);
     RUN_TEST(tr, parse::TestNumbers);
+    RUN_TEST(tr, parse::TestLineNumbers);
     RUN_TEST(tr, parse::TestIds);
     RUN_TEST(tr, parse::TestStrings);
     RUN_TEST(tr, parse::TestOperations);
     RUN_TEST(tr, parse::TestIndentsAndNewlines);
     RUN_TEST(tr, parse::TestEmptyLinesAreIgnored);
+    RUN_TEST(tr, parse::TestDedentsAtEndOfInput);
     RUN_TEST(tr, parse::TestExpect);
     RUN_TEST(tr, parse::TestExpectNext);
     RUN_TEST(tr, parse::TestMythonProgram);
     RUN_TEST(tr, parse::TestAlwaysEmitsNewlineAtTheEndOfNonemptyLine);
     RUN_TEST(tr, parse::TestCommentsAreIgnored);
+    RUN_TEST(tr, parse::TestCommentsInBlocks);
+    RUN_TEST(tr, parse::TestFirstLine);
 }
 
 } // namespace parse
\ No newline at end of file
@@ -16,11 +16,16 @@ namespace ast {
 void RunUnitTests(TestRunner &tr);
 }
 namespace runtime {
+void RunBigIntTests(TestRunner &tr);
+void RunModuleTests(TestRunner &tr);
 void RunObjectHolderTests(TestRunner &tr);
 void RunObjectsTests(TestRunner &tr);
+void RunProfilerTests(TestRunner &tr);
+void RunSnapshotTests(TestRunner &tr);
 } // namespace runtime
 
 void TestParseProgram(TestRunner &tr);
+void RunWorkloadTests(TestRunner &tr);
 
 namespace {
 
@@ -114,10 +119,15 @@ print y.value
 void TestAll() {
     TestRunner tr;
     parse::RunOpenLexerTests(tr);
+    runtime::RunBigIntTests(tr);
     runtime::RunObjectHolderTests(tr);
     runtime::RunObjectsTests(tr);
+    runtime::RunProfilerTests(tr);
+    runtime::RunSnapshotTests(tr);
+    runtime::RunModuleTests(tr);
     ast::RunUnitTests(tr);
     TestParseProgram(tr);
+    RunWorkloadTests(tr);
 
     RUN_TEST(tr, TestSimplePrints);
     RUN_TEST(tr, TestAssignments);
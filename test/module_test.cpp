@@ -0,0 +1,283 @@
+#include "lexer.h"
+#include "module.h"
+#include "parse.h"
+#include "test_runner.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace runtime {
+
+namespace {
+
+// Каталог с файлами модулей, подключённый к кэшу на время теста
+class ModuleDirectory {
+  public:
+    ModuleDirectory()
+        : path_(fs::temp_directory_path() /
+                ("mython_module_test_"s +
+                 to_string(chrono::steady_clock::now().time_since_epoch().count()))) {
+        fs::create_directories(path_);
+        ModuleCache::Instance().Clear();
+        ModuleCache::Instance().SetSearchPath({path_});
+    }
+
+    ModuleDirectory(const ModuleDirectory &) = delete;
+    ModuleDirectory &operator=(const ModuleDirectory &) = delete;
+
+    ~ModuleDirectory() {
+        ModuleCache::Instance().Clear();
+        ModuleCache::Instance().SetSearchPath({"."});
+        error_code error;
+        fs::remove_all(path_, error);
+    }
+
+    // Записывает модуль name. Время изменения сдвигается вперёд, чтобы кэш заметил изменение
+    // файла того же размера, записанного в пределах разрешения часов файловой системы
+    void Write(const string &name, const string &source) {
+        const fs::path path = path_ / (name + string(ModuleCache::EXTENSION));
+        const bool existed = fs::exists(path);
+        const auto previous = existed ? fs::last_write_time(path) : fs::file_time_type::min();
+        ofstream(path) << source;
+        if (existed) {
+            fs::last_write_time(path, previous + chrono::seconds(1));
+        }
+    }
+
+  private:
+    fs::path path_;
+};
+
+const string SHAPES = R"(
+class Rect:
+  def __init__(w, h):
+    self.w = w
+    self.h = h
+
+  def area():
+    return self.w * self.h
+
+print 'shapes loaded'
+unit = Rect(1, 1)
+registry = []
+)";
+
+unique_ptr<Executable> Parse(const string &program) {
+    istringstream input(program);
+    parse::Lexer lexer(input);
+    return ParseProgram(lexer);
+}
+
+string Run(Executable &program) {
+    Closure globals;
+    ostringstream output;
+    SimpleContext context{output};
+    program.Execute(globals, context);
+    return output.str();
+}
+
+string Run(const string &program) {
+    return Run(*Parse(program));
+}
+
+void TestImportDeclaresClassesAndGlobals() {
+    ModuleDirectory modules;
+    modules.Write("shapes"s, SHAPES);
+    ASSERT_EQUAL(Run("import shapes\n"
+                     "r = Rect(2, 3)\n"
+                     "print r.area(), unit.area()\n"
+                     "class Square(Rect):\n"
+                     "  def __init__(side):\n"
+                     "    self.w = side\n"
+                     "    self.h = side\n"
+                     "\n"
+                     "s = Square(4)\n"
+                     "print s.area()\n"s),
+                 "6 1\n16\n"s);
+}
+
+// Модуль разбирается и исполняется один раз; его изменяемые переменные у каждой программы свои
+void TestModuleLoadedOnce() {
+    ModuleDirectory modules;
+    modules.Write("shapes"s, SHAPES);
+    const size_t loads = ModuleCache::Instance().GetLoadCount();
+    const string program = "import shapes\n"
+                           "registry.append(unit)\n"
+                           "unit.w = 5\n"
+                           "print len(registry), unit.area()\n"s;
+    ASSERT_EQUAL(Run(program), "1 5\n"s);
+    ASSERT_EQUAL(Run(program), "1 5\n"s);
+    ASSERT_EQUAL(ModuleCache::Instance().GetLoadCount(), loads + 1);
+}
+
+// Изменённый модуль загружается заново, программы, разобранные раньше, видят прежнюю версию
+void TestModuleReloadedOnChange() {
+    ModuleDirectory modules;
+    modules.Write("config"s, "limit = 1\n"s);
+    const auto before = Parse("import config\nprint limit\n"s);
+
+    modules.Write("config"s, "limit = 2\n"s);
+    const size_t loads = ModuleCache::Instance().GetLoadCount();
+    ASSERT_EQUAL(Run("import config\nprint limit\n"s), "2\n"s);
+    ASSERT_EQUAL(ModuleCache::Instance().GetLoadCount(), loads + 1);
+    ASSERT_EQUAL(Run(*before), "1\n"s);
+}
+
+// Модуль, импортирующий изменённый модуль, тоже загружается заново
+void TestNestedImport() {
+    ModuleDirectory modules;
+    modules.Write("base"s, "class Base:\n  def name():\n    return 'base'\n"s);
+    modules.Write("derived"s, "import base\n"
+                              "class Derived(Base):\n"
+                              "  def describe():\n"
+                              "    return 'derived from ' + self.name()\n"
+                              "\n"
+                              "default = Derived()\n"s);
+    const string program = "import derived\n"
+                           "d = Derived()\n"
+                           "print d.describe(), default.name()\n"s;
+    ASSERT_EQUAL(Run(program), "derived from base base\n"s);
+
+    modules.Write("base"s, "class Base:\n  def name():\n    return 'root'\n"s);
+    ASSERT_EQUAL(Run(program), "derived from root root\n"s);
+}
+
+void TestImportErrors() {
+    ModuleDirectory modules;
+    modules.Write("first"s, "import second\nx = 1\n"s);
+    modules.Write("second"s, "import first\ny = 2\n"s);
+    modules.Write("broken"s, "x = \n"s);
+    ASSERT_THROWS(Parse("import missing\n"s), ParseError);
+    ASSERT_THROWS(Parse("import first\n"s), ParseError);
+    ASSERT_THROWS(Parse("import broken\n"s), parse::LexerError);
+    ASSERT_THROWS(Parse("class A:\n  def f():\n    import first\n"s), ParseError);
+
+    // Сообщение об ошибке модуля начинается с его имени
+    modules.Write("failing"s, "x = 1 / 0\n"s);
+    const auto get_error = [](const string &program) {
+        try {
+            (void)Parse(program);
+        } catch (const RuntimeError &e) {
+            return string(e.what());
+        }
+        return ""s;
+    };
+    ASSERT_EQUAL(get_error("import failing\n"s), "Module failing: division by zero"s);
+    modules.Write("outer"s, "import failing\n"s);
+    ASSERT_EQUAL(get_error("import outer\n"s),
+                 "Module outer: Module failing: division by zero"s);
+
+    // После ошибки кэш остаётся работоспособным
+    modules.Write("second"s, "y = 2\n"s);
+    ASSERT_EQUAL(Run("import first\nprint x, y\n"s), "1 2\n"s);
+}
+
+// Модуль исполняется с ограничениями контекста, в котором разбирается программа
+void TestImportLimits() {
+    ModuleDirectory modules;
+    modules.Write("spin"s, "while True:\n  x = 1\n"s);
+    ostringstream output;
+    SimpleContext context{output};
+
+    ExecutionLimits limits;
+    limits.max_steps = 1000;
+    context.SetLimits(limits);
+    ASSERT_THROWS(Parse("import spin\n"s), ExecutionLimitExceeded);
+
+    limits = {};
+    limits.deadline = chrono::steady_clock::now() + chrono::milliseconds(10);
+    context.SetLimits(limits);
+    ASSERT_THROWS(Parse("import spin\n"s), ExecutionLimitExceeded);
+
+    // Шаги модуля и программы учитываются в одном ограничении: каждый из них укладывается в
+    // него, а вместе они его превышают
+    modules.Write("count"s, "for i in range(0, 600):\n  x = i\n"s);
+    limits = {};
+    limits.max_steps = 1000;
+    context.SetLimits(limits);
+    const auto program = Parse("import count\nfor i in range(0, 600):\n  y = i\n"s);
+    ASSERT(context.GetSteps() >= 600U);
+    Closure globals;
+    ASSERT_THROWS(program->Execute(globals, context), ExecutionLimitExceeded);
+
+    // Загруженный модуль больше не исполняется, и программа укладывается в ограничение
+    context.SetLimits(limits);
+    globals.clear();
+    program->Execute(globals, context);
+    ASSERT(context.GetSteps() < 1000U);
+}
+
+// Вывод верхнего уровня модуля попадает в поток контекста, в котором разбирается программа.
+// Модуль, исполнение которого завершилось ошибкой, не исполняется повторно ни параллельным,
+// ни инкрементальным разбором
+void TestModuleOutput() {
+    ModuleDirectory modules;
+    modules.Write("shapes"s, SHAPES);
+    ostringstream output;
+    SimpleContext context{output};
+    const auto program = Parse("import shapes\nprint unit.area()\n"s);
+    ASSERT_EQUAL(output.str(), "shapes loaded\n"s);
+    Closure globals;
+    program->Execute(globals, context);
+    ASSERT_EQUAL(output.str(), "shapes loaded\n1\n"s);
+
+    modules.Write("failing"s, "print 'failing loaded'\nx = 1 / 0\n"s);
+    output.str({});
+    ASSERT_THROWS((void)ParseProgram("import failing\n"sv, 4), RuntimeError);
+    ASSERT_EQUAL(output.str(), "failing loaded\n"s);
+    output.str({});
+    IncrementalParser parser;
+    ASSERT_THROWS((void)parser.Parse("import failing\n"sv), RuntimeError);
+    ASSERT_EQUAL(output.str(), "failing loaded\n"s);
+}
+
+// Программы, импортирующие один модуль, разбираются и исполняются в нескольких потоках
+void TestImportInThreads() {
+    ModuleDirectory modules;
+    modules.Write("shapes"s, SHAPES);
+    const string program = "import shapes\n"
+                           "for i in range(0, 50):\n"
+                           "  registry.append(Rect(i, 2))\n"
+                           "last = registry[49]\n"
+                           "print len(registry), last.area()\n"s;
+    const string expected = "50 98\n"s;
+
+    constexpr size_t THREADS = 4;
+    constexpr size_t RUNS = 20;
+    vector<size_t> matches(THREADS);
+    vector<thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < RUNS; ++i) {
+                matches[t] += Run(program) == expected ? 1 : 0;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (size_t count : matches) {
+        ASSERT_EQUAL(count, RUNS);
+    }
+}
+
+} // namespace
+
+void RunModuleTests(TestRunner &tr) {
+    RUN_TEST(tr, TestImportDeclaresClassesAndGlobals);
+    RUN_TEST(tr, TestModuleLoadedOnce);
+    RUN_TEST(tr, TestModuleReloadedOnChange);
+    RUN_TEST(tr, TestNestedImport);
+    RUN_TEST(tr, TestImportErrors);
+    RUN_TEST(tr, TestImportLimits);
+    RUN_TEST(tr, TestModuleOutput);
+    RUN_TEST(tr, TestImportInThreads);
+}
+
+} // namespace runtime
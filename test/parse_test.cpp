@@ -3,6 +3,15 @@
 #include "statement.h"
 #include "test_runner.h"
 
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <pthread.h>
+
 using namespace std;
 
 namespace parse {
@@ -244,6 +253,891 @@ print r, c, t1, t2
                  "Rect(10x20) Circle(52) Triangle(3, 4, 5) Wrong triangle\n"s);
 }
 
+void TestInheritanceChain() {
+    const string program = R"(
+class A:
+  def name():
+    return 'A'
+
+  def greet():
+    return 'Hello from ' + self.name()
+
+class B(A):
+  def name():
+    return 'B'
+
+class C(B):
+  def other():
+    return 0
+
+class D(C):
+  def other():
+    return 1
+
+d = D()
+c = C()
+print d.greet(), c.name(), d.other()
+)"s;
+
+    runtime::DummyContext context;
+    runtime::Closure closure;
+    ParseProgramFromString(program)->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(), "Hello from B B 1\n"s);
+}
+
+void TestManyArguments() {
+    const string program = R"(
+class Summator:
+  def __init__(a, b, c, d, e, f, g, h, i, j):
+    self.total = a + b + c + d + e + f + g + h + i + j
+
+  def sum(a, b, c, d, e, f, g, h, i, j):
+    return a + b + c + d + e + f + g + h + i + j
+
+  def pair(a, b):
+    return a * 10 + b
+
+s = Summator(1, 2, 3, 4, 5, 6, 7, 8, 9, 10)
+print s.total, s.sum(10, 20, 30, 40, 50, 60, 70, 80, 90, 100), s.pair(4, s.pair(0, 2))
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(), "55 550 42\n"s);
+}
+
+void TestDeepTailRecursion() {
+    const string program = R"(
+class Counter:
+  def count(n, acc):
+    if n == 0:
+      return acc
+    return self.count(n - 1, acc + 2)
+
+  def is_even(n):
+    if n == 0:
+      return True
+    return self.is_odd(n - 1)
+
+  def is_odd(n):
+    if n == 0:
+      return False
+    return self.is_even(n - 1)
+
+c = Counter()
+print c.count(1000000, 0)
+print c.is_even(100001), c.is_odd(100001)
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(), "2000000\nFalse True\n"s);
+}
+
+void TestTailCallOnReassignedSelf() {
+    const string program = R"(
+class Named:
+  def __init__(name):
+    self.name = name
+
+  def name_of(other):
+    self = other
+    return self.get_name()
+
+  def get_name():
+    return self.name
+
+a = Named('a')
+b = Named('b')
+print a.name_of(b)
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(), "b\n"s);
+}
+
+// Параметр хвостового вызова вычисляется вызовом метода, который сам выполняет хвостовой вызов
+void TestNestedTailCallInArguments() {
+    const string program = R"(
+class A:
+  def g(x):
+    return self.h(x)
+
+  def h(x):
+    return x + 100
+
+  def f(a, b):
+    return a * 1000 + b
+
+  def run():
+    return self.f(1, self.g(2))
+
+a = A()
+print a.run()
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(), "1102\n"s);
+}
+
+void TestWhileLoop() {
+    const string program = R"(
+class Search:
+  def first_square_above(limit):
+    i = 0
+    while True:
+      if i * i > limit:
+        return i
+      i = i + 1
+
+i = 0
+total = 0
+while i < 10:
+  j = 0
+  while j < i:
+    total = total + 1
+    j = j + 1
+  i = i + 1
+print i, total
+
+s = Search()
+print s.first_square_above(50)
+while False:
+  print 'never'
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(), "10 45\n8\n"s);
+}
+
+void TestForRangeLoop() {
+    const string program = R"(
+class Finder:
+  def find(values_count, target):
+    for i in range(0, values_count):
+      if i * i == target:
+        return i
+    return None
+
+total = 0
+for i in range(0, 5):
+  total = total + i
+print total
+
+saved = 0
+for i in range(10, 0, -3):
+  if i == 7:
+    saved = i
+  print i
+print saved, i
+
+n = 3
+for k in range(n, n * 2):
+  total = total + k
+print total
+
+for j in range(5, 5):
+  print 'never'
+
+f = Finder()
+print f.find(100, 49), f.find(5, 49)
+
+for i in range(9223372036854775800, 9223372036854775807, 5):
+  print i
+for i in range(-9223372036854775800, -9223372036854775807 - 1, -5):
+  print i
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(),
+                 "10\n10\n7\n4\n1\n7 1\n22\n7 None\n"
+                 "9223372036854775800\n9223372036854775805\n"
+                 "-9223372036854775800\n-9223372036854775805\n"s);
+    ASSERT(closure.count("j"s) == 0);
+}
+
+void TestForRangeErrors() {
+    ASSERT_THROWS(ParseProgramFromString("for i in range(0, 10, 0):\n  print i\n"s),
+                  ParseError);
+    ASSERT_THROWS(ParseProgramFromString("for i in range(1):\n  print i\n"s), ParseError);
+    ASSERT_THROWS(ParseProgramFromString("for i in values(1, 2):\n  print i\n"s),
+                  ParseError);
+
+    runtime::DummyContext context;
+    runtime::Closure closure;
+    auto zero_step = ParseProgramFromString("s = 0\nfor i in range(0, 10, s):\n  print i\n"s);
+    ASSERT_THROWS(zero_step->Execute(closure, context), std::runtime_error);
+    auto bad_bound = ParseProgramFromString("for i in range(0, 'a'):\n  print i\n"s);
+    ASSERT_THROWS(bad_bound->Execute(closure, context), std::runtime_error);
+}
+
+void TestStringBuilding() {
+    const string program = R"(
+class Joiner:
+  def join(items, separator):
+    result = ''
+    first = True
+    for item in items:
+      if not first:
+        result = result + separator
+      result = result + str(item)
+      first = False
+    return result
+
+s = ''
+for i in range(0, 2000):
+  s = s + 'line ' + str(i) + ';'
+print len(s), s == s
+t = s
+s = s + 'tail'
+print len(t), len(s), t + 'tail' == s, 'line 1999;' in t, s == t
+
+j = Joiner()
+print j.join([1, 'two', None], ', ')
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(), "18890 True\n18890 18894 True True False\n1, two, None\n"s);
+}
+
+void TestBigNumbers() {
+    const string program = R"(
+class Factorial:
+  def calc(n):
+    if n < 2:
+      return 1
+    return n * self.calc(n - 1)
+
+f = Factorial()
+print f.calc(13), f.calc(30)
+
+max = 9223372036854775807
+min = -max - 1
+big = max + 1
+print big, min - 1, -min, min / -1
+print big - 1 == max, big > max, min - 1 < min, big == max + 1
+
+# Результат, снова умещающийся в 64 бита, становится обычным числом
+d = {max: 'max'}
+print d[big - 1], str(big * big / big - 1), f.calc(25) / f.calc(23)
+
+# Литералы, не умещающиеся в 64 бита
+literal = 1180591620717411303424
+smallest = -9223372036854775808
+print literal, literal == big * 128, -36893488147419103232 / 2, smallest == min
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(),
+                 "6227020800 265252859812191058636308480000000\n"
+                 "9223372036854775808 -9223372036854775809 9223372036854775808 "
+                 "9223372036854775808\n"
+                 "True True True True\n"
+                 "max 9223372036854775807 600\n"
+                 "1180591620717411303424 True -18446744073709551616 True\n"s);
+    ASSERT(closure.at("big"s).TryAs<runtime::BigNumber>());
+    ASSERT(closure.at("max"s).TryAs<runtime::Number>());
+    ASSERT(closure.at("literal"s).TryAs<runtime::BigNumber>());
+    ASSERT(closure.at("smallest"s).TryAs<runtime::Number>());
+}
+
+void TestPureMethods() {
+    const string program = R"(
+class Fibonacci:
+  @pure
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+class Greeter:
+  def __init__():
+    self.greeted = 0
+
+  @pure
+  def greeting(name):
+    print 'computing', name
+    return 'Hello, ' + name
+
+  def greet(name):
+    self.greeted = self.greeted + 1
+    return self.greeting(name)
+
+fib = Fibonacci()
+print fib.calc(80)
+
+g = Greeter()
+print g.greet('Ann')
+print g.greet('Bob')
+print g.greet('Ann'), g.greeted
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(),
+                 "23416728348467685\n"
+                 "computing Ann\nHello, Ann\n"
+                 "computing Bob\nHello, Bob\n"
+                 "Hello, Ann 3\n"s);
+
+    const auto &cls = *closure.at("Fibonacci"s).TryAs<runtime::Class>();
+    const auto &stats = cls.GetMethod("calc"s)->cache->GetStats();
+    ASSERT_EQUAL(stats.misses, 81U);
+    ASSERT_EQUAL(stats.hits, 78U);
+}
+
+void TestPureMethodErrors() {
+    ASSERT_THROWS(ParseProgramFromString(R"(
+class A:
+  @cached
+  def f():
+    return 1
+)"s),
+                  ParseError);
+    ASSERT_THROWS(ParseProgramFromString(R"(
+class A:
+  @pure
+  x = 1
+)"s),
+                  LexerError);
+}
+
+void TestLists() {
+    const string program = R"(
+class Stack:
+  def __init__():
+    self.items = []
+
+  def push(value):
+    self.items.append(value)
+
+  def top():
+    return self.items[-1]
+
+x = [1, 'two', None]
+print x, len(x), x[0], x[-2]
+x[2] = [3, 4]
+x[2][0] = 5
+x.append(6)
+print x, len(x[2]), len([]), len('abc')
+
+total = 0
+for item in [1, 2, 3] + [4]:
+  total = total + item
+print total
+
+y = x
+y.append(7)
+print len(x), x[1:3], x[:2], x[4:], x[-2:], x[10:]
+print [1, [2]] == [1, [2]], [1] == [1, 2], [] == []
+
+s = Stack()
+for i in range(0, 3):
+  s.push(i * i)
+print s.items, s.top()
+
+grow = [1]
+for item in grow:
+  if item < 4:
+    grow.append(item + 1)
+print grow
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(),
+                 "[1, two, None] 3 1 two\n"
+                 "[1, two, [5, 4], 6] 2 0 3\n"
+                 "10\n"
+                 "5 [two, [5, 4]] [1, two] [7] [6, 7] []\n"
+                 "True False True\n"
+                 "[0, 1, 4] 4\n"
+                 "[1, 2, 3, 4]\n"s);
+}
+
+void TestListErrors() {
+    runtime::DummyContext context;
+    runtime::Closure closure;
+    auto execute = [&](const string &program) {
+        ParseProgramFromString(program)->Execute(closure, context);
+    };
+    ASSERT_THROWS(execute("x = [1]\nprint x[1]\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("x = [1]\nx[-2] = 0\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("x = [1]\nprint x['a']\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("x = 1\nprint x[0]\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("x = [1]\nx.pop()\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("for i in 5:\n  print i\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("print len(1)\n"s), std::runtime_error);
+    ASSERT_THROWS(ParseProgramFromString("x = [1\n"s), LexerError);
+    ASSERT_THROWS(ParseProgramFromString("x[0]\n"s), LexerError);
+}
+
+void TestDicts() {
+    const string program = R"(
+class Counter:
+  def __init__():
+    self.counts = {}
+
+  def add(word):
+    if word in self.counts:
+      self.counts[word] = self.counts[word] + 1
+    else:
+      self.counts[word] = 1
+
+d = {'one': 1, 2: 'two', None: [3]}
+print d, len(d), d['one'], d[2], d[None][0]
+d['one'] = 'uno'
+d[True] = {}
+d[True]['nested'] = 5
+print d['one'], d[True], 2 in d, 3 in d, 'b' in ['a', 'b'], 'ell' in 'hello'
+
+keys = []
+for key in d:
+  keys.append(key)
+print keys, len({})
+
+c = Counter()
+for word in ['a', 'b', 'a', 'c', 'a']:
+  c.add(word)
+print c.counts
+print {1: 2} == {1: 2}, {1: 2} == {1: 3}, {1: 2} == {2: 2}, not 'x' in c.counts
+)"s;
+
+    runtime::DummyContext context;
+
+    runtime::Closure closure;
+    auto tree = ParseProgramFromString(program);
+    tree->Execute(closure, context);
+
+    ASSERT_EQUAL(context.output.str(),
+                 "{one: 1, 2: two, None: [3]} 3 1 two 3\n"
+                 "uno {nested: 5} True False True True\n"
+                 "[one, 2, None, True] 0\n"
+                 "{a: 3, b: 1, c: 1}\n"
+                 "True False False True\n"s);
+}
+
+void TestDictErrors() {
+    runtime::DummyContext context;
+    runtime::Closure closure;
+    auto execute = [&](const string &program) {
+        ParseProgramFromString(program)->Execute(closure, context);
+    };
+    ASSERT_THROWS(execute("d = {1: 2}\nprint d[2]\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("d = {[1]: 2}\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("d = {}\nd[{}] = 1\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("d = {}\nprint d[0:1]\n"s), std::runtime_error);
+    ASSERT_THROWS(execute("print 1 in 2\n"s), std::runtime_error);
+    ASSERT_THROWS(ParseProgramFromString("d = {1 2}\n"s), LexerError);
+    ASSERT_THROWS(ParseProgramFromString("d = {1: 2\n"s), LexerError);
+}
+
+void TestExecutionStats() {
+    if (!runtime::ExecutionStats::ENABLED) {
+        return;
+    }
+    using NodeType = runtime::ExecutionStats::NodeType;
+    using ObjectType = runtime::ExecutionStats::ObjectType;
+
+    auto tree = ParseProgramFromString(R"(
+class Counter:
+  def __init__():
+    self.value = 0
+
+  def add(n):
+    self.value = self.value + n
+    return self.value
+
+c = Counter()
+for i in range(0, 3):
+  c.add(i)
+print c.value, 'x'
+print c.value / 0
+)"s);
+    runtime::DummyContext context;
+    runtime::Closure closure;
+    ASSERT_THROWS(tree->Execute(closure, context), std::runtime_error);
+
+    const auto &stats = context.GetStats();
+    auto nodes = [&stats](NodeType type) {
+        return stats.nodes[static_cast<size_t>(type)];
+    };
+    auto allocations = [&stats](ObjectType type) {
+        return stats.allocations[static_cast<size_t>(type)];
+    };
+    ASSERT_EQUAL(nodes(NodeType::ClassDefinition), 1U);
+    ASSERT_EQUAL(nodes(NodeType::ForRange), 1U);
+    ASSERT_EQUAL(nodes(NodeType::MethodCall), 3U);
+    ASSERT_EQUAL(nodes(NodeType::NewInstance), 1U);
+    ASSERT_EQUAL(nodes(NodeType::FieldAssignment), 4U);
+    ASSERT_EQUAL(nodes(NodeType::Print), 2U);
+    ASSERT_EQUAL(nodes(NodeType::Div), 1U);
+    ASSERT_EQUAL(stats.method_calls, 4U);
+    ASSERT_EQUAL(allocations(ObjectType::ClassInstance), 1U);
+    ASSERT_EQUAL(allocations(ObjectType::List), 0U);
+    // Counter, c и i; self в четырёх вызовах, n в трёх и поле value
+    ASSERT_EQUAL(stats.closure_insertions, 11U);
+    ASSERT_EQUAL(stats.exceptions, 1U);
+
+    // Счётчики принадлежат контексту: повторный запуск в новом контексте считается заново
+    runtime::DummyContext other_context;
+    runtime::Closure other_closure;
+    ASSERT_THROWS(tree->Execute(other_closure, other_context), std::runtime_error);
+    ASSERT_EQUAL(other_context.GetStats().method_calls, 4U);
+    ASSERT_EQUAL(context.GetStats().method_calls, 4U);
+}
+
+// Выполняет program с ограничениями limits и возвращает причину превышения ограничения
+std::optional<runtime::ExecutionLimitExceeded::Reason> ExecuteWithLimits(
+    const string &program, const runtime::ExecutionLimits &limits, runtime::Context &context) {
+    auto tree = ParseProgramFromString(program);
+    context.SetLimits(limits);
+    runtime::Closure closure;
+    try {
+        tree->Execute(closure, context);
+    } catch (const runtime::ExecutionLimitExceeded &e) {
+        return e.GetReason();
+    }
+    return std::nullopt;
+}
+
+// Исполняет body в потоке со стеком размером stack_size и передаёт вызывающему исключение,
+// которым завершился body
+void RunWithStackSize(size_t stack_size, const function<void()> &body) {
+    struct Task {
+        const function<void()> &body;
+        exception_ptr error;
+    } task{body, nullptr};
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, stack_size);
+    pthread_t thread;
+    const int error = pthread_create(
+        &thread, &attr,
+        [](void *arg) -> void * {
+            auto &task = *static_cast<Task *>(arg);
+            try {
+                task.body();
+            } catch (...) {
+                task.error = current_exception();
+            }
+            return nullptr;
+        },
+        &task);
+    pthread_attr_destroy(&attr);
+    ASSERT_EQUAL(error, 0);
+    pthread_join(thread, nullptr);
+    if (task.error) {
+        rethrow_exception(task.error);
+    }
+}
+
+void TestExecutionLimits() {
+    using Reason = runtime::ExecutionLimitExceeded::Reason;
+    const string recursion = R"(
+class Recursion:
+  def sum(n):
+    if n == 0:
+      return 0
+    return n + self.sum(n - 1)
+
+  def count(n):
+    if n == 0:
+      return 0
+    return self.count(n - 1)
+
+r = Recursion()
+)"s;
+
+    {
+        // Шаги - итерации циклов и входы в методы
+        runtime::DummyContext context;
+        const string program =
+            "x = 0\nwhile x < 10:\n  x = x + 1\nfor i in range(0, 5):\n  x = x + i\n"s;
+        ASSERT(!ExecuteWithLimits(program, {15, {}}, context));
+        ASSERT_EQUAL(context.GetSteps(), 15U);
+        ASSERT(ExecuteWithLimits(program, {14, {}}, context) == Reason::Steps);
+        ASSERT(ExecuteWithLimits("while True:\n  x = 1\n"s, {1000, {}}, context) == Reason::Steps);
+        ASSERT(ExecuteWithLimits(recursion + "print r.count(100)\n"s, {100, {}}, context) ==
+               Reason::Steps);
+    }
+    {
+        runtime::DummyContext context;
+        runtime::ExecutionLimits limits;
+        limits.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        ASSERT(ExecuteWithLimits("while True:\n  x = 1\n"s, limits, context) == Reason::Deadline);
+        ASSERT(std::chrono::steady_clock::now() >= *limits.deadline);
+    }
+    {
+        runtime::DummyContext context;
+        runtime::ExecutionLimits limits;
+        limits.max_call_depth = 50;
+        ASSERT(!ExecuteWithLimits(recursion + "print r.sum(49)\n"s, limits, context));
+        ASSERT(ExecuteWithLimits(recursion + "print r.sum(50)\n"s, limits, context) ==
+               Reason::CallDepth);
+        // Хвостовая рекурсия не увеличивает глубину
+        ASSERT(!ExecuteWithLimits(recursion + "print r.count(10000)\n"s, limits, context));
+        ASSERT_EQUAL(context.output.str(), "1225\n0\n"s);
+    }
+    {
+        // Рекурсия, которой не хватает стека потока, завершается ошибкой и без явного
+        // ограничения глубины, и с ограничением, превышающим возможную глубину. Граница стека
+        // определяется для каждого потока, поэтому рекурсия исполняется в потоке с небольшим
+        // стеком
+        const string deep_recursion = recursion + "print r.sum(100000000)\n"s;
+        RunWithStackSize(2 * 1024 * 1024, [&] {
+            runtime::DummyContext context;
+            ASSERT(!ExecuteWithLimits(recursion + "print r.sum(100)\n"s, {}, context));
+            ASSERT_EQUAL(context.output.str(), "5050\n"s);
+            ASSERT(ExecuteWithLimits(deep_recursion, {}, context) == Reason::CallDepth);
+            runtime::ExecutionLimits limits;
+            limits.max_call_depth = 100000000;
+            ASSERT(ExecuteWithLimits(deep_recursion, limits, context) == Reason::CallDepth);
+            ASSERT_EQUAL(runtime::FrameStack::Instance().Depth(), 0U);
+        });
+    }
+    {
+        runtime::DummyContext context;
+        runtime::ExecutionLimits limits;
+        limits.max_memory = 100000;
+        const string program = "l = []\nwhile True:\n  l.append(str(len(l)))\n"s;
+        ASSERT(ExecuteWithLimits(program, limits, context) == Reason::Memory);
+        ASSERT(context.GetPeakMemoryUsage() <= 100000);
+        ASSERT(context.GetPeakMemoryUsage() > 90000);
+    }
+}
+
+// Библиотека из count классов: цепочки наследования по пять классов, методы, создающие
+// объекты других классов, комментарии, многострочный строковый литерал и инструкции между
+// определениями классов
+string MakeLibrary(size_t count) {
+    string program = "# library\ntotal = 0\ntext = 'first\nclass Fake:\n  def f():'\n"s;
+    for (size_t i = 0; i < count; ++i) {
+        const string n = to_string(i);
+        const string root = "Item"s + to_string(i - i % 5);
+        program += i % 5 == 0 ? "class Item"s + n + ":\n"s
+                              : "class Item"s + n + "(Item"s + to_string(i - 1) + "):\n"s;
+        program += "  def value():\n"
+                   "    # comment\n"
+                   "    return "s + n + "\n"s
+                   "\n"
+                   "  def make():\n"
+                   "    return "s + (i % 5 == 0 ? "None"s : root + "()"s) + "\n"s
+                   "# between classes\n"
+                   "\n"s;
+        if (i % 1000 == 999) {
+            program += "total = total + "s + n + "\n"s;
+        }
+    }
+    const string last = "Item"s + to_string(count - 1);
+    return program + "item = "s + last + "()\nmade = item.make()\n"s +
+           "print total, item.value(), made.value(), len(text)\n"s;
+}
+
+string Run(runtime::Executable &program) {
+    runtime::DummyContext context;
+    runtime::Closure closure;
+    program.Execute(closure, context);
+    return context.output.str();
+}
+
+void TestParallelParse() {
+    const string library = MakeLibrary(2503);
+    ASSERT(library.size() > 2 * PARALLEL_PARSE_MIN_BYTES);
+
+    const string expected = "2998 2502 2500 28\n"s;
+    ASSERT_EQUAL(Run(*ParseProgramFromString(library)), expected);
+    ASSERT_EQUAL(Run(*ParseProgram(library, 1)), expected);
+    ASSERT_EQUAL(Run(*ParseProgram(library, 4)), expected);
+    ASSERT_EQUAL(Run(*ParseProgram("print 1"sv)), "1\n"s);
+    ASSERT_EQUAL(Run(*ParseProgram(""sv)), ""s);
+}
+
+// Возвращает сообщение об ошибке, с которой завершился разбор parse
+template <typename Parse>
+string GetParseError(Parse parse) {
+    try {
+        parse();
+    } catch (const std::exception &e) {
+        return e.what();
+    }
+    return {};
+}
+
+// Параллельный разбор сообщает о тех же ошибках, что и последовательный, в том числе об
+// упоминании класса, объявленного позже
+void TestParallelParseErrors() {
+    const string library = MakeLibrary(1000);
+    const string missing_class = "class Early:\n  def f():\n    return Later()\n\n"s;
+    const string later_class = "class Later:\n  def g():\n    return 1\n"s;
+    const vector<string> programs = {
+        missing_class + library + later_class,
+        "class Early(Later):\n  def f():\n    return 1\n\n"s + library + later_class,
+        library + "class Item7:\n  def f():\n    return 1\n"s,
+        later_class + library + later_class,
+        library + "class Broken:\n  def f(:\n    return 1\n"s,
+    };
+    for (const string &program : programs) {
+        const string expected = GetParseError([&] {
+            ParseProgramFromString(program);
+        });
+        ASSERT(!expected.empty());
+        ASSERT_EQUAL(GetParseError([&] {
+                         ParseProgram(program, 4);
+                     }),
+                     expected);
+    }
+}
+
+// Возвращает класс name, объявленный программой program
+const runtime::Object *GetDeclaredClass(runtime::Executable &program, const string &name) {
+    runtime::DummyContext context;
+    runtime::Closure closure;
+    program.Execute(closure, context);
+    return closure.at(name).Get();
+}
+
+void TestIncrementalParse() {
+    const string base = "class Base:\n  def name():\n    return 'base'\n\n"s;
+    const string derived = "class Derived(Base):\n  def describe():\n    return 'derived'\n\n"s;
+    const string user = "class User:\n  def make():\n    return Derived()\n\n"s;
+    const string other = "class Other:\n  def name():\n    return 'other'\n\n"s;
+    const string main = "u = User()\nd = u.make()\no = Other()\nprint d.name(), d.describe(), o.name()\n"s;
+
+    IncrementalParser parser;
+    const auto first = parser.Parse(base + derived + user + other + main);
+    ASSERT_EQUAL(parser.GetStats().parsed, 5u);
+    ASSERT_EQUAL(parser.GetStats().reused, 0u);
+    ASSERT_EQUAL(Run(*first), "base derived other\n"s);
+
+    // Изменение метода без изменения числа строк: заново разбираются изменённый класс и
+    // инструкции, создающие его объекты
+    const string new_other = "class Other:\n  def name():\n    return 'changed'\n\n"s;
+    const auto second = parser.Parse(base + derived + user + new_other + main);
+    ASSERT_EQUAL(parser.GetStats().parsed, 2u);
+    ASSERT_EQUAL(parser.GetStats().reused, 3u);
+    ASSERT_EQUAL(Run(*second), "base derived changed\n"s);
+    ASSERT(GetDeclaredClass(*second, "Derived"s) == GetDeclaredClass(*first, "Derived"s));
+    ASSERT(GetDeclaredClass(*second, "Other"s) != GetDeclaredClass(*first, "Other"s));
+    // Прежняя версия исполняется по-прежнему
+    ASSERT_EQUAL(Run(*first), "base derived other\n"s);
+
+    // Изменение базового класса: заново разбираются все части, зависящие от него
+    const string new_base = "class Base:\n  def name():\n    return 'root'\n\n"s;
+    const auto third = parser.Parse(new_base + derived + user + new_other + main);
+    ASSERT_EQUAL(parser.GetStats().parsed, 4u);
+    ASSERT_EQUAL(parser.GetStats().reused, 1u);
+    ASSERT_EQUAL(Run(*third), "root derived changed\n"s);
+
+    // Изменение первой строки изменяет текст первой части и всех зависящих от неё
+    const auto fourth = parser.Parse("# header\n"s + new_base + derived + user + new_other + main);
+    ASSERT_EQUAL(parser.GetStats().parsed, 4u);
+    ASSERT_EQUAL(parser.GetStats().reused, 1u);
+    ASSERT_EQUAL(Run(*fourth), "root derived changed\n"s);
+}
+
+// Части, сместившиеся из-за вставки строк, берутся из прежней версии
+void TestIncrementalParseMovedChunks() {
+    const string base = "class Base:\n  def name():\n    return 'base'\n\n"s;
+    const string derived = "class Derived(Base):\n  def describe():\n    return 'derived'\n\n"s;
+    const string main = "d = Derived()\nprint d.name(), d.describe()\n"s;
+
+    IncrementalParser parser;
+    const auto first = parser.Parse(base + derived + main);
+    ASSERT_EQUAL(Run(*first), "base derived\n"s);
+
+    const auto second = parser.Parse("greeting = 'hi'\n\n"s + base + derived + main);
+    ASSERT_EQUAL(parser.GetStats().parsed, 1u);
+    ASSERT_EQUAL(parser.GetStats().reused, 3u);
+    ASSERT_EQUAL(Run(*second), "base derived\n"s);
+    ASSERT(GetDeclaredClass(*second, "Base"s) == GetDeclaredClass(*first, "Base"s));
+    ASSERT(GetDeclaredClass(*second, "Derived"s) == GetDeclaredClass(*first, "Derived"s));
+
+    // Удаление строк, как и вставка, не требует разбора сместившихся частей
+    const auto third = parser.Parse(base + derived + main);
+    ASSERT_EQUAL(parser.GetStats().parsed, 0u);
+    ASSERT_EQUAL(parser.GetStats().reused, 3u);
+    ASSERT(GetDeclaredClass(*third, "Derived"s) == GetDeclaredClass(*first, "Derived"s));
+}
+
+// Ошибка разбора сообщается так же, как при последовательном разборе, а следующая версия
+// сравнивается с последней разобранной без ошибок
+void TestIncrementalParseErrors() {
+    const string first = "class A:\n  def f():\n    return 1\n\n"s;
+    const string second = "class B:\n  def g():\n    return A()\n\n"s;
+    const string main = "b = B()\na = b.g()\nprint a.f()\n"s;
+
+    IncrementalParser parser;
+    ASSERT_EQUAL(Run(*parser.Parse(first + second + main)), "1\n"s);
+
+    const vector<string> broken = {
+        first + "class B:\n  def g(:\n    return A()\n\n"s + main,
+        first + second + first + main,
+        second + first + main,
+    };
+    for (const string &program : broken) {
+        const string expected = GetParseError([&] {
+            ParseProgramFromString(program);
+        });
+        ASSERT(!expected.empty());
+        ASSERT_EQUAL(GetParseError([&] {
+                         parser.Parse(program);
+                     }),
+                     expected);
+    }
+
+    ASSERT_EQUAL(Run(*parser.Parse(first + second + "print 2\n"s)), "2\n"s);
+    ASSERT_EQUAL(parser.GetStats().parsed, 1u);
+    ASSERT_EQUAL(parser.GetStats().reused, 2u);
+}
+
 } // namespace parse
 
 void TestParseProgram(TestRunner &tr) {
@@ -255,4 +1149,27 @@ void TestParseProgram(TestRunner &tr) {
     RUN_TEST(tr, parse::TestRecursion2);
     RUN_TEST(tr, parse::TestComplexLogicalExpression);
     RUN_TEST(tr, parse::TestClassicalPolymorphism);
+    RUN_TEST(tr, parse::TestInheritanceChain);
+    RUN_TEST(tr, parse::TestManyArguments);
+    RUN_TEST(tr, parse::TestDeepTailRecursion);
+    RUN_TEST(tr, parse::TestTailCallOnReassignedSelf);
+    RUN_TEST(tr, parse::TestNestedTailCallInArguments);
+    RUN_TEST(tr, parse::TestWhileLoop);
+    RUN_TEST(tr, parse::TestForRangeLoop);
+    RUN_TEST(tr, parse::TestForRangeErrors);
+    RUN_TEST(tr, parse::TestStringBuilding);
+    RUN_TEST(tr, parse::TestBigNumbers);
+    RUN_TEST(tr, parse::TestPureMethods);
+    RUN_TEST(tr, parse::TestPureMethodErrors);
+    RUN_TEST(tr, parse::TestExecutionStats);
+    RUN_TEST(tr, parse::TestExecutionLimits);
+    RUN_TEST(tr, parse::TestLists);
+    RUN_TEST(tr, parse::TestListErrors);
+    RUN_TEST(tr, parse::TestDicts);
+    RUN_TEST(tr, parse::TestDictErrors);
+    RUN_TEST(tr, parse::TestParallelParse);
+    RUN_TEST(tr, parse::TestParallelParseErrors);
+    RUN_TEST(tr, parse::TestIncrementalParse);
+    RUN_TEST(tr, parse::TestIncrementalParseMovedChunks);
+    RUN_TEST(tr, parse::TestIncrementalParseErrors);
 }
\ No newline at end of file
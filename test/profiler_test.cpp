@@ -0,0 +1,200 @@
+#include "lexer.h"
+#include "parse.h"
+#include "profiler.h"
+#include "statement.h"
+#include "test_runner.h"
+
+#include <functional>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+
+using namespace std;
+
+namespace runtime {
+
+namespace {
+
+// Тело метода, которое выполняет заданную функцию
+class CallbackBody : public Executable {
+  public:
+    explicit CallbackBody(function<void()> callback) : callback_(std::move(callback)) {
+    }
+
+    ObjectHolder Execute(Closure & /*closure*/, Context & /*context*/) override {
+        callback_();
+        return ObjectHolder::None();
+    }
+
+  private:
+    function<void()> callback_;
+};
+
+// Буфер вывода, который делает выборку профилировщика в конце каждой напечатанной строки
+class SamplingBuffer : public streambuf {
+  public:
+    explicit SamplingBuffer(Profiler &profiler) : profiler_(profiler) {
+    }
+
+  protected:
+    int_type overflow(int_type ch) override {
+        if (ch == '\n') {
+            profiler_.TakeSample();
+        }
+        return ch;
+    }
+
+  private:
+    Profiler &profiler_;
+};
+
+void TestCallStackSnapshot() {
+    auto &calls = CallStack::Instance();
+    calls.SetLine(3);
+
+    vector<Method> methods;
+    methods.push_back({"outer"s, {}, nullptr, 1});
+    methods.push_back({"inner"s, {}, nullptr, 1});
+    Class cls{"Test"s, std::move(methods), nullptr};
+    const Method &outer = *cls.GetMethod("outer"s);
+    const Method &inner = *cls.GetMethod("inner"s);
+
+    calls.Push(cls, outer);
+    calls.SetLine(10);
+    calls.Push(cls, inner);
+    calls.Replace(outer);
+    calls.SetLine(11);
+
+    auto frames = calls.Snapshot();
+    ASSERT_EQUAL(frames.size(), 3u);
+    ASSERT(frames[0].method == nullptr);
+    ASSERT_EQUAL(frames[0].line, 3u);
+    ASSERT(frames[1].cls == &cls && frames[1].method == &outer);
+    ASSERT_EQUAL(frames[1].line, 10u);
+    ASSERT(frames[2].method == &outer);
+    ASSERT_EQUAL(frames[2].line, 11u);
+
+    calls.Pop();
+    calls.Pop();
+    ASSERT_EQUAL(calls.Snapshot().size(), 1u);
+}
+
+void TestProfilerFoldedStacks() {
+    auto &calls = CallStack::Instance();
+    calls.SetLine(7);
+    Profiler profiler(calls);
+
+    vector<Method> methods;
+    methods.push_back({"run"s, {}, make_unique<CallbackBody>([&] {
+                           calls.SetLine(2);
+                           profiler.TakeSample();
+                           profiler.TakeSample();
+                           calls.SetLine(4);
+                           profiler.TakeSample();
+                       }),
+                       1});
+    Class cls{"Worker"s, std::move(methods), nullptr};
+    ClassInstance instance{cls};
+    DummyContext context;
+
+    instance.Call("run"s, {}, context);
+    profiler.TakeSample();
+
+    ASSERT_EQUAL(profiler.GetSampleCount(), 4u);
+    ostringstream output;
+    profiler.WriteFolded(output);
+    ASSERT_EQUAL(output.str(), "<module>:7 1\n<module>:7;Worker.run:2 2\n<module>:7;Worker.run:4 1\n"s);
+}
+
+void TestProfilerAttributesLines() {
+    istringstream input(R"(
+class Greeter:
+  def greet(n):
+    x = n
+
+    print x
+
+  def twice(n):
+    self.greet(n)
+    return self.greet(n)
+
+g = Greeter()
+g.twice(1)
+print 'done'
+)");
+    parse::Lexer lexer(input);
+    auto program = ParseProgram(lexer);
+
+    Profiler profiler(CallStack::Instance());
+    SamplingBuffer buffer(profiler);
+    ostream output(&buffer);
+    SimpleContext context{output};
+    Closure closure;
+    program->Execute(closure, context);
+
+    // Хвостовой вызов greet выполняется в кадре twice
+    ostringstream folded;
+    profiler.WriteFolded(folded);
+    ASSERT_EQUAL(folded.str(),
+                 "<module>:13;Greeter.greet:6 1\n"
+                 "<module>:13;Greeter.twice:9;Greeter.greet:6 1\n"
+                 "<module>:14 1\n"s);
+}
+
+// Профиль программы, разобранной IncrementalParser, в свёрнутом формате
+string ProfileLines(Executable &program) {
+    Profiler profiler(CallStack::Instance());
+    SamplingBuffer buffer(profiler);
+    ostream output(&buffer);
+    SimpleContext context{output};
+    Closure closure;
+    program.Execute(closure, context);
+    ostringstream folded;
+    profiler.WriteFolded(folded);
+    return folded.str();
+}
+
+// Части, которые IncrementalParser взял из прежней версии со сдвигом, профилируются с номерами
+// строк новой версии
+void TestProfilerLinesAfterIncrementalParse() {
+    const string program = "class Greeter:\n"
+                           "  def greet():\n"
+                           "    print 'hi'\n"
+                           "\n"
+                           "g = Greeter()\n"
+                           "g.greet()\n"s;
+    IncrementalParser parser;
+    ASSERT_EQUAL(ProfileLines(*parser.Parse(program)), "<module>:6;Greeter.greet:3 1\n"s);
+
+    const auto moved = parser.Parse("x = 1\ny = 2\n"s + program);
+    ASSERT_EQUAL(parser.GetStats().reused, 2u);
+    ASSERT_EQUAL(ProfileLines(*moved), "<module>:8;Greeter.greet:5 1\n"s);
+}
+
+void TestProfilerThread() {
+    auto &calls = CallStack::Instance();
+    Profiler profiler(calls, chrono::microseconds(100));
+    profiler.Start();
+    const auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+    while (profiler.GetSampleCount() < 3 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    profiler.Stop();
+
+    const size_t samples = profiler.GetSampleCount();
+    ASSERT(samples >= 3);
+    this_thread::sleep_for(chrono::milliseconds(2));
+    ASSERT_EQUAL(profiler.GetSampleCount(), samples);
+}
+
+} // namespace
+
+void RunProfilerTests(TestRunner &tr) {
+    RUN_TEST(tr, runtime::TestCallStackSnapshot);
+    RUN_TEST(tr, runtime::TestProfilerFoldedStacks);
+    RUN_TEST(tr, runtime::TestProfilerAttributesLines);
+    RUN_TEST(tr, runtime::TestProfilerLinesAfterIncrementalParse);
+    RUN_TEST(tr, runtime::TestProfilerThread);
+}
+
+} // namespace runtime
@@ -2,6 +2,7 @@
 #include "test_runner.h"
 
 #include <functional>
+#include <map>
 
 using namespace std;
 
@@ -71,6 +72,86 @@ void TestString() {
     ASSERT_EQUAL(word.GetValue(), "hello!"s);
 }
 
+void TestSharedString() {
+    static_assert(sizeof(SharedString) == 32);
+
+    const SharedString empty;
+    ASSERT(empty.empty());
+    ASSERT_EQUAL(empty, ""s);
+
+    const string short_text = "short string"s;
+    const string long_text = "a string that does not fit into the object"s;
+    const SharedString short_str(short_text);
+    const SharedString long_str(long_text);
+    ASSERT_EQUAL(short_str, short_text);
+    ASSERT_EQUAL(long_str, long_text);
+    ASSERT_EQUAL(long_str.size(), long_text.size());
+
+    // Копия длинной строки разделяет буфер с оригиналом
+    SharedString long_copy = long_str;
+    ASSERT(long_copy.View().data() == long_str.View().data());
+    ASSERT(long_copy == long_str);
+    SharedString short_copy = short_str;
+    ASSERT(short_copy == short_str);
+
+    SharedString moved = std::move(long_copy);
+    ASSERT(moved == long_str);
+    ASSERT(long_copy.empty()); // NOLINT(bugprone-use-after-move)
+    moved = short_str;
+    ASSERT(moved == short_str);
+
+    // Строки одной длины с разными символами
+    const SharedString other_long(long_text.substr(1) + "!"s);
+    ASSERT_EQUAL(other_long.Hash() == long_str.Hash(), false);
+    ASSERT(!(other_long == long_str));
+    ASSERT(!(short_str == long_str));
+    ASSERT((short_str < long_str) == (short_text < long_text));
+
+    ASSERT_EQUAL(long_str.Hash(), std::hash<string_view>{}(long_text));
+    ASSERT_EQUAL(short_str.Hash(), std::hash<string_view>{}(short_text));
+
+    ASSERT_EQUAL(SharedString::Concat("abc"sv, "def"sv), "abcdef"s);
+    ASSERT_EQUAL(SharedString::Concat(short_text, long_text), short_text + long_text);
+    ASSERT_EQUAL(SharedString::Concat(""sv, ""sv), ""s);
+}
+
+void TestStringRope() {
+    DummyContext ctx;
+    const string piece = "0123456789"s;
+    string expected;
+    ObjectHolder rope = ObjectHolder::Own(String(""s));
+    {
+        // Константа, которой ObjectHolder не владеет, может быть уничтожена раньше строки
+        String constant(piece);
+        for (int i = 0; i < 10000; ++i) {
+            rope = String::Concat(rope, ObjectHolder::Share(constant));
+            rope = String::Concat(rope, ObjectHolder::Own(String(to_string(i % 10))));
+            expected += piece + to_string(i % 10);
+        }
+    }
+    const ObjectHolder prefix = rope;
+    rope = String::Concat(ObjectHolder::Own(String(">"s)), rope);
+    expected = ">"s + expected;
+
+    const auto *str = rope.TryAs<String>();
+    ASSERT(str);
+    ASSERT_EQUAL(str->Size(), expected.size());
+    ASSERT(IsTrue(rope));
+    ASSERT(!Equal(rope, ObjectHolder::Own(String("short"s)), ctx));
+    ASSERT(Equal(rope, ObjectHolder::Own(String(expected)), ctx));
+    ASSERT_EQUAL(str->GetValue(), expected);
+    ASSERT_EQUAL(prefix.TryAs<String>()->GetValue(), expected.substr(1));
+    ASSERT_EQUAL(HashKey(rope), HashKey(ObjectHolder::Own(String(expected))));
+
+    ostringstream out;
+    rope->Print(out, ctx);
+    ASSERT_EQUAL(out.str(), expected);
+
+    const auto empty = ObjectHolder::Own(String(""s));
+    ASSERT_EQUAL(String::Concat(empty, empty).TryAs<String>()->GetValue(), ""s);
+    ASSERT(String::Concat(rope, empty).Get() == rope.Get());
+}
+
 void TestBool() {
     Bool t(true);
     ASSERT_EQUAL(t.GetValue(), true);
@@ -243,6 +324,26 @@ void TestMove() {
     }
 }
 
+void TestCopy() {
+    static_assert(sizeof(ObjectHolder) == sizeof(void *));
+    {
+        ASSERT_EQUAL(Logger::instance_count, 0);
+        auto one = ObjectHolder::Own(Logger(5));
+        ObjectHolder two = one;
+        ASSERT(two.Get() == one.Get());
+
+        one = ObjectHolder::None();
+        ASSERT_EQUAL(Logger::instance_count, 1);
+
+        ObjectHolder three;
+        three = two;
+        two = three;
+        two = ObjectHolder::None();
+        ASSERT_EQUAL(Logger::instance_count, 1);
+    }
+    ASSERT_EQUAL(Logger::instance_count, 0);
+}
+
 void TestNullptr() {
     ObjectHolder oh;
     ASSERT(!oh);
@@ -550,23 +651,407 @@ void TestClassInstance() {
     ASSERT_THROWS(instance.Call("missing_method"s, {}, ctx), runtime_error);
 }
 
+void TestList() {
+    DummyContext ctx;
+    List list({ObjectHolder::Own(Number(1)), ObjectHolder::Own(String("two"s)), ObjectHolder()});
+    list.Append(ObjectHolder::Own(Number(4)));
+
+    ASSERT_EQUAL(list.Size(), 4U);
+    ASSERT_EQUAL(list.At(0).TryAs<Number>()->GetValue(), 1);
+    ASSERT_EQUAL(list.At(-1).TryAs<Number>()->GetValue(), 4);
+    ASSERT(!list.At(2));
+    ASSERT_THROWS(list.At(4), runtime_error);
+    ASSERT_THROWS(list.At(-5), runtime_error);
+
+    ostringstream out;
+    list.Print(out, ctx);
+    ASSERT_EQUAL(out.str(), "[1, two, None, 4]"s);
+
+    ASSERT_EQUAL(list.Slice(1, 3).Size(), 2U);
+    ASSERT_EQUAL(list.Slice(-2, nullopt).At(0).Get(), list.At(2).Get());
+    ASSERT_EQUAL(list.Slice(nullopt, 100).Size(), 4U);
+    ASSERT_EQUAL(list.Slice(3, 1).Size(), 0U);
+
+    ASSERT(List::HasMethod("append"s, 1));
+    ASSERT(!List::HasMethod("append"s, 0));
+    list.Call("append"s, {ObjectHolder::Own(Number(5))}, ctx);
+    ASSERT_EQUAL(list.Size(), 5U);
+    ASSERT_THROWS(list.Call("pop"s, {}, ctx), runtime_error);
+
+    ASSERT(IsTrue(ObjectHolder::Share(list)));
+    List empty;
+    ASSERT(!IsTrue(ObjectHolder::Share(empty)));
+
+    // Список, содержащий сам себя
+    auto self_ref = ObjectHolder::Own(List());
+    self_ref.TryAs<List>()->Append(ObjectHolder::Share(*self_ref));
+    ostringstream self_out;
+    self_ref->Print(self_out, ctx);
+    ASSERT_EQUAL(self_out.str(), "[[...]]"s);
+}
+
+void TestDict() {
+    DummyContext ctx;
+    Dict dict;
+    ASSERT(!dict.Find(ObjectHolder::Own(Number(1))));
+    ASSERT(!IsTrue(ObjectHolder::Share(dict)));
+
+    dict.Set(ObjectHolder::Own(Number(1)), ObjectHolder::Own(String("one"s)));
+    dict.Set(ObjectHolder::Own(String("1"s)), ObjectHolder::Own(Number(1)));
+    dict.Set(ObjectHolder::Own(Bool(true)), ObjectHolder());
+    dict.Set(ObjectHolder(), ObjectHolder::Own(Number(0)));
+    ASSERT_EQUAL(dict.Size(), 4U);
+    ASSERT(IsTrue(ObjectHolder::Share(dict)));
+
+    // Ключи разных типов различаются, а равные ключи - совпадают
+    ASSERT_EQUAL(dict.At(ObjectHolder::Own(Number(1))).TryAs<String>()->GetValue(), "one"s);
+    ASSERT_EQUAL(dict.At(ObjectHolder::Own(String("1"s))).TryAs<Number>()->GetValue(), 1);
+    ASSERT(!dict.At(ObjectHolder::Own(Bool(true))));
+    ASSERT_EQUAL(dict.At(ObjectHolder()).TryAs<Number>()->GetValue(), 0);
+    ASSERT_THROWS(dict.At(ObjectHolder::Own(Bool(false))), runtime_error);
+    ASSERT_THROWS(dict.Set(ObjectHolder::Own(List()), ObjectHolder()), runtime_error);
+
+    dict.Set(ObjectHolder::Own(Number(1)), ObjectHolder::Own(String("uno"s)));
+    ASSERT_EQUAL(dict.Size(), 4U);
+
+    ostringstream out;
+    dict.Print(out, ctx);
+    ASSERT_EQUAL(out.str(), "{1: uno, 1: 1, True: None, None: 0}"s);
+
+    // Таблица растёт, сохраняя порядок добавления ключей
+    Dict numbers;
+    const int count = 10000;
+    for (int i = 0; i < count; ++i) {
+        numbers.Set(ObjectHolder::Own(Number(i * 7)), ObjectHolder::Own(Number(i)));
+    }
+    ASSERT_EQUAL(numbers.Size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        const ObjectHolder *value = numbers.Find(ObjectHolder::Own(Number(i * 7)));
+        ASSERT(value && value->TryAs<Number>()->GetValue() == i);
+        ASSERT(!numbers.Find(ObjectHolder::Own(Number(i * 7 + 1))));
+        ASSERT_EQUAL(numbers.Items()[i].key.TryAs<Number>()->GetValue(), i * 7);
+    }
+
+    ASSERT_EQUAL(HashKey(ObjectHolder::Own(String("key"s))),
+                 HashKey(ObjectHolder::Own(String("key"s))));
+    ASSERT_THROWS(HashKey(ObjectHolder::Own(Dict())), runtime_error);
+}
+
+void TestContains() {
+    DummyContext ctx;
+    Dict dict;
+    dict.Set(ObjectHolder::Own(String("a"s)), ObjectHolder());
+    List list({ObjectHolder::Own(Number(1)), ObjectHolder::Own(String("b"s))});
+
+    ASSERT(Contains(ObjectHolder::Own(String("a"s)), ObjectHolder::Share(dict), ctx));
+    ASSERT(!Contains(ObjectHolder::Own(String("b"s)), ObjectHolder::Share(dict), ctx));
+    ASSERT(Contains(ObjectHolder::Own(String("b"s)), ObjectHolder::Share(list), ctx));
+    ASSERT(!Contains(ObjectHolder::Own(Number(2)), ObjectHolder::Share(list), ctx));
+    ASSERT(Contains(ObjectHolder::Own(String("ll"s)), ObjectHolder::Own(String("hello"s)), ctx));
+    ASSERT_THROWS(Contains(ObjectHolder::Own(Number(1)), ObjectHolder::Own(String("1"s)), ctx),
+                  runtime_error);
+    ASSERT_THROWS(Contains(ObjectHolder::Own(Number(1)), ObjectHolder::Own(Number(1)), ctx),
+                  runtime_error);
+}
+
+void TestFramesAreReused() {
+    auto &frames = FrameStack::Instance();
+    const size_t depth = frames.Depth();
+
+    vector<const Closure *> passed_frames;
+    auto body = [&passed_frames, &frames, depth](Closure &closure, Context & /*ctx*/) {
+        ASSERT_EQUAL(frames.Depth(), depth + 1);
+        passed_frames.push_back(&closure);
+        if (closure.at("fail"s).TryAs<Bool>()->GetValue()) {
+            throw runtime_error("failure"s);
+        }
+        return ObjectHolder::None();
+    };
+    vector<Method> methods;
+    methods.push_back({"method"s, {"fail"s}, make_unique<TestMethodBody>(body), 4});
+    Class cls{"Test"s, std::move(methods), nullptr};
+    ClassInstance instance{cls};
+
+    DummyContext context;
+    instance.Call("method"s, {ObjectHolder::Own(Bool{false})}, context);
+    ASSERT_EQUAL(frames.Depth(), depth);
+    ASSERT_THROWS(instance.Call("method"s, {ObjectHolder::Own(Bool{true})}, context),
+                  runtime_error);
+    ASSERT_EQUAL(frames.Depth(), depth);
+    instance.Call("method"s, {ObjectHolder::Own(Bool{false})}, context);
+
+    ASSERT_EQUAL(passed_frames.size(), 3U);
+    ASSERT(passed_frames[0] == passed_frames[1] && passed_frames[1] == passed_frames[2]);
+}
+
+// Возвращает имена переменных closure в порядке возрастания и значения через пробел
+string DumpClosure(const Closure &closure) {
+    map<string, int64_t> values;
+    for (const auto &[name, value] : closure) {
+        ASSERT(values.emplace(name, value.TryAs<Number>()->GetValue()).second);
+    }
+    string result;
+    for (const auto &[name, value] : values) {
+        result += (result.empty() ? ""s : " "s) + name + "="s + to_string(value);
+    }
+    return result;
+}
+
+void TestClosureFork() {
+    Closure base = {{"a"s, ObjectHolder::Own(Number(1))}, {"b"s, ObjectHolder::Own(Number(2))}};
+    Closure fork = base.Fork();
+    ASSERT_EQUAL(fork.size(), 2U);
+    ASSERT_EQUAL(fork.OwnSize(), 0U);
+    ASSERT_EQUAL(base.OwnSize(), 0U);
+    ASSERT(fork.at("a"s).Get() == base.at("a"s).Get());
+
+    // Запись копирует переменную слоя, чтение - нет
+    ASSERT_EQUAL(fork.count("b"s), 1U);
+    ObjectHolder &a = fork["a"s];
+    ASSERT_EQUAL(fork.OwnSize(), 1U);
+    a = ObjectHolder::Own(Number(10));
+    fork["c"s] = ObjectHolder::Own(Number(3));
+    base["b"s] = ObjectHolder::Own(Number(20));
+    ASSERT(&a == &fork["a"s]);
+
+    ASSERT_EQUAL(DumpClosure(fork), "a=10 b=2 c=3"s);
+    ASSERT_EQUAL(DumpClosure(base), "a=1 b=20"s);
+    ASSERT_EQUAL(fork.size(), 3U);
+    ASSERT_EQUAL(base.size(), 2U);
+    ASSERT(fork.find("d"s) == fork.end());
+    ASSERT_THROWS(fork.at("d"s), out_of_range);
+    ASSERT(!fork.emplace("b"s, ObjectHolder::None()));
+
+    // Копия таблицы копирует только её собственные переменные
+    const Closure copy = fork;
+    ASSERT_EQUAL(copy.OwnSize(), 2U);
+    ASSERT_EQUAL(DumpClosure(copy), "a=10 b=2 c=3"s);
+
+    fork.clear();
+    ASSERT(fork.empty());
+    ASSERT_EQUAL(DumpClosure(copy), "a=10 b=2 c=3"s);
+}
+
+// Цепочка из многих Fork сливается в один слой, не теряя переменных
+void TestClosureForkChain() {
+    Closure closure;
+    vector<Closure> forks;
+    for (int i = 0; i < 3 * static_cast<int>(Closure::MAX_LAYERS); ++i) {
+        closure["v"s + to_string(i % 5)] = ObjectHolder::Own(Number(i));
+        forks.push_back(closure.Fork());
+    }
+    ASSERT_EQUAL(DumpClosure(closure), "v0=20 v1=21 v2=22 v3=23 v4=19"s);
+    ASSERT_EQUAL(DumpClosure(forks[6]), "v0=5 v1=6 v2=2 v3=3 v4=4"s);
+    ASSERT_EQUAL(forks.back().size(), 5U);
+}
+
+void TestCallCache() {
+    CallCache cache(2);
+    const auto number = [](int value) {
+        return ObjectHolder::Own(Number(value));
+    };
+
+    ASSERT(cache.Find({number(1)}) == nullptr);
+    cache.Insert({number(1)}, ObjectHolder::Own(String("one"s)));
+    const ObjectHolder *hit = cache.Find({number(1)});
+    ASSERT(hit != nullptr);
+    ASSERT_EQUAL(hit->TryAs<String>()->GetValue(), "one"sv);
+    // Значения разных типов - разные ключи
+    ASSERT(cache.Find({ObjectHolder::Own(Bool(true))}) == nullptr);
+    ASSERT(cache.Find({number(1), number(1)}) == nullptr);
+
+    // Вытесняется результат, который дольше всего не использовался
+    cache.Insert({number(2)}, number(4));
+    ASSERT(cache.Find({number(1)}) != nullptr);
+    cache.Insert({number(3)}, number(9));
+    ASSERT_EQUAL(cache.Size(), 2U);
+    ASSERT(cache.Find({number(2)}) == nullptr);
+    ASSERT(cache.Find({number(1)}) != nullptr);
+    ASSERT(cache.Find({number(3)}) != nullptr);
+
+    // Объекты не могут быть ключом, а изменяемые результаты не сохраняются
+    Class cls{"Test"s, {}, nullptr};
+    ClassInstance instance{cls};
+    ASSERT(cache.Find({ObjectHolder::Share(instance)}) == nullptr);
+    cache.Insert({ObjectHolder::Share(instance)}, number(0));
+    cache.Insert({number(5)}, ObjectHolder::Own(List()));
+    ASSERT(cache.Find({number(5)}) == nullptr);
+
+    // Значения, которыми кэш не владеет, копируются
+    {
+        Number key(7);
+        String result("seven"s);
+        cache.Insert({ObjectHolder::Share(key)}, ObjectHolder::Share(result));
+    }
+    hit = cache.Find({number(7)});
+    ASSERT(hit != nullptr && hit->IsOwner());
+    ASSERT_EQUAL(hit->TryAs<String>()->GetValue(), "seven"sv);
+
+    const auto &stats = cache.GetStats();
+    ASSERT_EQUAL(stats.hits, 5U);
+    ASSERT_EQUAL(stats.misses, 5U);
+    ASSERT_EQUAL(stats.evictions, 2U);
+    ASSERT_EQUAL(stats.uncacheable, 1U);
+}
+
+void TestPureMethodCall() {
+    int executions = 0;
+    auto body = [&executions](Closure &closure, Context & /*ctx*/) {
+        ++executions;
+        return closure.at("x"s);
+    };
+    vector<Method> methods;
+    methods.push_back({"identity"s, {"x"s}, make_unique<TestMethodBody>(body), 2,
+                       make_unique<CallCache>()});
+    Class cls{"Test"s, std::move(methods), nullptr};
+    ClassInstance instance{cls};
+    DummyContext context;
+
+    for (int i = 0; i < 3; ++i) {
+        const ObjectHolder result =
+            instance.Call("identity"s, {ObjectHolder::Own(String("abc"s))}, context);
+        ASSERT_EQUAL(result.TryAs<String>()->GetValue(), "abc"sv);
+    }
+    ASSERT_EQUAL(executions, 1);
+
+    // Вызов с изменяемым параметром выполняется каждый раз
+    for (int i = 0; i < 2; ++i) {
+        instance.Call("identity"s, {ObjectHolder::Own(List())}, context);
+    }
+    ASSERT_EQUAL(executions, 3);
+}
+
+void TestCycleCollection() {
+    auto &gc = GarbageCollector::Instance();
+    const size_t tracked_before = gc.GetStats().tracked;
+
+    Class cls{"Node"s, {}, nullptr};
+    {
+        auto a = ObjectHolder::Own(ClassInstance{cls});
+        auto b = ObjectHolder::Own(ClassInstance{cls});
+        a.TryAs<ClassInstance>()->Fields()["other"s] = b;
+        a.TryAs<ClassInstance>()->Fields()["payload"s] = ObjectHolder::Own(Logger(1));
+        b.TryAs<ClassInstance>()->Fields()["other"s] = a;
+        ASSERT_EQUAL(gc.GetStats().tracked, tracked_before + 2);
+
+        // Цикл достижим через переменные a и b
+        ASSERT_EQUAL(gc.Collect(), 0U);
+        ASSERT_EQUAL(Logger::instance_count, 1);
+    }
+    // Переменные уничтожены, но экземпляры удерживают друг друга
+    ASSERT_EQUAL(gc.GetStats().tracked, tracked_before + 2);
+
+    const size_t collections = gc.GetStats().collections;
+    ASSERT_EQUAL(gc.Collect(), 2U);
+    ASSERT_EQUAL(gc.GetStats().tracked, tracked_before);
+    ASSERT_EQUAL(gc.GetStats().collections, collections + 1);
+    ASSERT_EQUAL(Logger::instance_count, 0);
+}
+
+void TestCollectionKeepsExternallyReachable() {
+    auto &gc = GarbageCollector::Instance();
+
+    Class cls{"Node"s, {}, nullptr};
+    ClassInstance root{cls};
+    auto child = ObjectHolder::Own(ClassInstance{cls});
+    child.TryAs<ClassInstance>()->Fields()["self"s] = child;
+    root.Fields()["child"s] = child;
+    child = ObjectHolder::None();
+
+    // Экземпляр на стеке - корень, поэтому цикл child.self достижим через root.child
+    ASSERT_EQUAL(gc.Collect(), 0U);
+    ASSERT(root.Fields().at("child"s).TryAs<ClassInstance>()->Fields().count("self"s));
+
+    root.Fields().clear();
+    ASSERT_EQUAL(gc.Collect(), 1U);
+}
+
+void TestMemoryUsage() {
+    DummyContext context;
+    ASSERT_EQUAL(context.GetMemoryUsage(), 0);
+    {
+        const auto number = ObjectHolder::Own(Number(1));
+        ASSERT_EQUAL(context.GetMemoryUsage(), static_cast<std::int64_t>(sizeof(Number)));
+
+        // Символы длинной строки учитываются вместе с объектом
+        const auto str = ObjectHolder::Own(String(string(1000, 'a')));
+        ASSERT(context.GetMemoryUsage() > 1000);
+
+        auto list = ObjectHolder::Own(List());
+        const std::int64_t before_append = context.GetMemoryUsage();
+        list.TryAs<List>()->Append(number);
+        ASSERT(context.GetMemoryUsage() >= before_append +
+                                               static_cast<std::int64_t>(sizeof(ObjectHolder)));
+    }
+    ASSERT_EQUAL(context.GetMemoryUsage(), 0);
+    const std::int64_t peak = context.GetPeakMemoryUsage();
+    ASSERT(peak > 1000);
+
+    // Наибольшее использование памяти во вложенном контексте учитывается и во внешнем
+    {
+        DummyContext inner;
+        const auto str = ObjectHolder::Own(String(string(10000, 'a')));
+        ASSERT(inner.GetPeakMemoryUsage() > 10000);
+    }
+    ASSERT(context.GetPeakMemoryUsage() > 10000);
+    ASSERT_EQUAL(context.GetMemoryUsage(), 0);
+}
+
+void TestMemoryQuota() {
+    DummyContext context;
+    ExecutionLimits limits;
+    limits.max_memory = 1000;
+    context.SetLimits(limits);
+
+    List list;
+    auto append = [&list] {
+        for (int i = 0; i < 1000; ++i) {
+            list.Append(ObjectHolder::Own(Number(i)));
+        }
+    };
+    ASSERT_THROWS(append(), ExecutionLimitExceeded);
+    // Отклонённое выделение не учитывается, а квота остаётся соблюдённой
+    ASSERT(context.GetMemoryUsage() <= 1000);
+    ASSERT(context.GetPeakMemoryUsage() <= 1000);
+
+    list.Items().clear();
+    list.Items().shrink_to_fit();
+    ASSERT_EQUAL(context.GetMemoryUsage(), 0);
+    ASSERT_DOESNT_THROW(list.Append(ObjectHolder::Own(Number(1))));
+}
+
 } // namespace
 
 void RunObjectsTests(TestRunner &tr) {
     RUN_TEST(tr, runtime::TestNumber);
     RUN_TEST(tr, runtime::TestString);
+    RUN_TEST(tr, runtime::TestSharedString);
+    RUN_TEST(tr, runtime::TestStringRope);
     RUN_TEST(tr, runtime::TestBool);
     RUN_TEST(tr, runtime::TestMethodInvocation);
     RUN_TEST(tr, runtime::TestIsTrue);
     RUN_TEST(tr, runtime::TestComparison);
     RUN_TEST(tr, runtime::TestClass);
     RUN_TEST(tr, runtime::TestClassInstance);
+    RUN_TEST(tr, runtime::TestList);
+    RUN_TEST(tr, runtime::TestDict);
+    RUN_TEST(tr, runtime::TestContains);
+    RUN_TEST(tr, runtime::TestFramesAreReused);
+    RUN_TEST(tr, runtime::TestClosureFork);
+    RUN_TEST(tr, runtime::TestClosureForkChain);
+    RUN_TEST(tr, runtime::TestCallCache);
+    RUN_TEST(tr, runtime::TestPureMethodCall);
+    RUN_TEST(tr, runtime::TestCycleCollection);
+    RUN_TEST(tr, runtime::TestCollectionKeepsExternallyReachable);
+    RUN_TEST(tr, runtime::TestMemoryUsage);
+    RUN_TEST(tr, runtime::TestMemoryQuota);
 }
 
 void RunObjectHolderTests(TestRunner &tr) {
     RUN_TEST(tr, runtime::TestNonowning);
     RUN_TEST(tr, runtime::TestOwning);
     RUN_TEST(tr, runtime::TestMove);
+    RUN_TEST(tr, runtime::TestCopy);
     RUN_TEST(tr, runtime::TestNullptr);
 }
 
@@ -0,0 +1,197 @@
+#include "lexer.h"
+#include "parse.h"
+#include "snapshot.h"
+#include "test_runner.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace runtime {
+
+namespace {
+
+const string PRELUDE = R"(
+class Counter:
+  def __init__():
+    self.count = 0
+
+  def add(step):
+    self.count = self.count + step
+    return self.count
+
+class Math:
+  @pure
+  def square(n):
+    return n * n
+
+greeting = 'Hello, ' + 'world'
+limit = 10
+counter = Counter()
+items = [1, 2]
+alias = items
+names = {'one': 1}
+math = Math()
+)";
+
+unique_ptr<Snapshot> MakeSnapshot(const string &prelude) {
+    istringstream input(prelude);
+    parse::Lexer lexer(input);
+    DummyContext context;
+    return make_unique<Snapshot>(ParseProgram(lexer), context);
+}
+
+unique_ptr<Executable> ParseRequest(const Snapshot &snapshot, const string &program) {
+    istringstream input(program);
+    parse::Lexer lexer(input);
+    return ParseProgram(lexer, snapshot.GetGlobals());
+}
+
+// Выполняет program с копией глобальных переменных снимка и возвращает вывод программы
+string RunFork(const Snapshot &snapshot, Executable &program) {
+    Closure globals = snapshot.Fork();
+    ostringstream output;
+    SimpleContext context{output};
+    program.Execute(globals, context);
+    return output.str();
+}
+
+string RunFork(const Snapshot &snapshot, const string &program) {
+    return RunFork(snapshot, *ParseRequest(snapshot, program));
+}
+
+void TestForkRunsPrelude() {
+    const auto snapshot = MakeSnapshot(PRELUDE);
+    ASSERT_EQUAL(RunFork(*snapshot, "print greeting, limit, counter.add(2), items, names\n"s),
+                 "Hello, world 10 2 [1, 2] {one: 1}\n"s);
+    ASSERT_EQUAL(RunFork(*snapshot, "c = Counter()\nprint c.add(5), math.square(7)\n"s),
+                 "5 49\n"s);
+    ASSERT_EQUAL(RunFork(*snapshot, "class Twice(Counter):\n"
+                                    "  def add(step):\n"
+                                    "    return self.count + 2 * step\n"
+                                    "\n"
+                                    "twice = Twice()\n"
+                                    "print twice.add(3)\n"s),
+                 "6\n"s);
+}
+
+// Изменения в копии не видны ни снимку, ни следующим копиям
+void TestForkIsolation() {
+    const auto snapshot = MakeSnapshot(PRELUDE);
+    const string request = "counter.add(1)\n"
+                           "items.append(limit)\n"
+                           "names['two'] = 2\n"
+                           "limit = limit + 1\n"
+                           "print counter.count, items, len(names), limit\n"s;
+    ASSERT_EQUAL(RunFork(*snapshot, request), "1 [1, 2, 10] 2 11\n"s);
+    ASSERT_EQUAL(RunFork(*snapshot, request), "1 [1, 2, 10] 2 11\n"s);
+
+    const Closure &globals = snapshot->GetGlobals();
+    ASSERT_EQUAL(globals.at("items"s).TryAs<List>()->Size(), 2u);
+    ASSERT_EQUAL(globals.at("names"s).TryAs<Dict>()->Size(), 1u);
+    ASSERT_EQUAL(globals.at("limit"s).TryAs<Number>()->GetValue(), 10);
+    const auto &counter = *globals.at("counter"s).TryAs<ClassInstance>();
+    ASSERT_EQUAL(counter.Fields().at("count"s).TryAs<Number>()->GetValue(), 0);
+}
+
+// Общие ссылки и циклы между изменяемыми объектами сохраняются в копии
+void TestForkPreservesSharing() {
+    const auto snapshot = MakeSnapshot(PRELUDE + "counter.self = counter\ncounter.items = items\n"s);
+    ASSERT_EQUAL(RunFork(*snapshot, "alias.append(3)\nprint len(items), counter.self.items\n"s),
+                 "3 [1, 2, 3]\n"s);
+
+    const Closure globals = snapshot->Fork();
+    const ObjectHolder &items = globals.at("items"s);
+    ASSERT(items.Get() == globals.at("alias"s).Get());
+    ASSERT(items.Get() != snapshot->GetGlobals().at("items"s).Get());
+
+    const ObjectHolder &counter = globals.at("counter"s);
+    const Closure &fields = counter.TryAs<ClassInstance>()->Fields();
+    ASSERT(fields.at("self"s).Get() == counter.Get());
+    ASSERT(fields.at("items"s).Get() == items.Get());
+}
+
+// Неизменяемые значения и классы не копируются и не становятся владельцами объектов снимка
+void TestForkSharesImmutables() {
+    const auto snapshot = MakeSnapshot(PRELUDE);
+    const Closure globals = snapshot->Fork();
+    for (const char *name : {"greeting", "limit", "Counter"}) {
+        const ObjectHolder &value = globals.at(name);
+        ASSERT(value.Get() == snapshot->GetGlobals().at(name).Get());
+        ASSERT(!value.IsOwner());
+    }
+}
+
+// Кэши чистых методов снимка заморожены: результаты вычисляются заново и не сохраняются
+void TestSnapshotFreezesPureMethods() {
+    const auto snapshot = MakeSnapshot(PRELUDE);
+    const auto &math = *snapshot->GetGlobals().at("Math"s).TryAs<Class>();
+    const CallCache &cache = *math.GetMethod("square"s)->cache;
+    ASSERT(cache.IsFrozen());
+
+    ASSERT_EQUAL(RunFork(*snapshot, "print math.square(3), math.square(3)\n"s), "9 9\n"s);
+    ASSERT_EQUAL(cache.Size(), 0u);
+    ASSERT_EQUAL(cache.GetStats().hits, 0u);
+}
+
+// Уничтожение снимка освобождает объекты, ссылающиеся друг на друга и на себя
+void TestSnapshotFreesCycles() {
+    DummyContext context;
+    MakeSnapshot("class Node:\n"
+                 "  def __init__():\n"
+                 "    self.next = self\n"
+                 "\n"
+                 "node = Node()\n"
+                 "items = [node]\n"
+                 "items.append(items)\n"
+                 "names = {'items': items}\n"
+                 "names['self'] = names\n"
+                 "node.names = names\n"s);
+    ASSERT_EQUAL(context.GetMemoryUsage(), 0);
+}
+
+// Копии одного снимка исполняются в нескольких потоках одновременно. Запрос разбирается
+// заранее: синтаксическое дерево, как и снимок, только читается при исполнении
+void TestForkInThreads() {
+    const auto snapshot = MakeSnapshot(PRELUDE);
+    const auto request =
+        ParseRequest(*snapshot, "for i in range(0, 100):\n"
+                                "  counter.add(math.square(2))\n"
+                                "  items.append(greeting + '!')\n"
+                                "fresh = Counter()\n"
+                                "print counter.count, len(items), items[2], fresh.add(limit)\n"s);
+    const string expected = "400 102 Hello, world! 10\n"s;
+
+    constexpr size_t THREADS = 4;
+    constexpr size_t FORKS = 50;
+    vector<size_t> matches(THREADS);
+    vector<thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < FORKS; ++i) {
+                matches[t] += RunFork(*snapshot, *request) == expected ? 1 : 0;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (size_t count : matches) {
+        ASSERT_EQUAL(count, FORKS);
+    }
+}
+
+} // namespace
+
+void RunSnapshotTests(TestRunner &tr) {
+    RUN_TEST(tr, TestForkRunsPrelude);
+    RUN_TEST(tr, TestForkIsolation);
+    RUN_TEST(tr, TestForkPreservesSharing);
+    RUN_TEST(tr, TestForkSharesImmutables);
+    RUN_TEST(tr, TestSnapshotFreezesPureMethods);
+    RUN_TEST(tr, TestSnapshotFreesCycles);
+    RUN_TEST(tr, TestForkInThreads);
+}
+
+} // namespace runtime
@@ -214,6 +214,38 @@ void TestStringify() {
         Stringify str(make_unique<None>());
         ASSERT_OBJECT_VALUE_EQUAL(str.Execute(empty, context), "None"s);
     }
+    {
+        ASSERT_OBJECT_VALUE_EQUAL(
+            Stringify(make_unique<NumericConst>(-2147483647 - 1)).Execute(empty, context),
+            "-2147483648"s);
+        ASSERT_OBJECT_VALUE_EQUAL(Stringify(make_unique<NumericConst>(0)).Execute(empty, context),
+                                  "0"s);
+        ASSERT_OBJECT_VALUE_EQUAL(Stringify(make_unique<BoolConst>(true)).Execute(empty, context),
+                                  "True"s);
+        ASSERT_OBJECT_VALUE_EQUAL(Stringify(make_unique<BoolConst>(false)).Execute(empty, context),
+                                  "False"s);
+    }
+    {
+        // Принадлежащая программе строка не копируется
+        runtime::Closure closure{{"s"s, ObjectHolder::Own(runtime::String("text"s))}};
+        auto result = Stringify(make_unique<VariableValue>("s"s)).Execute(closure, context);
+        ASSERT(result.Get() == closure.at("s"s).Get());
+    }
+    {
+        // __str__ наследуется от родителя, а метод __str__ с параметрами не используется
+        vector<runtime::Method> base_methods;
+        base_methods.push_back({"__str__"s, {}, make_unique<StringConst>("base"s)});
+        runtime::Class base("Base"s, std::move(base_methods), nullptr);
+        runtime::Class derived("Derived"s, {}, &base);
+        ASSERT(derived.GetStrMethod() == base.GetStrMethod());
+        ASSERT_OBJECT_VALUE_EQUAL(Stringify(make_unique<NewInstance>(derived)).Execute(empty, context),
+                                  "base"s);
+
+        vector<runtime::Method> methods;
+        methods.push_back({"__str__"s, {"x"s}, make_unique<StringConst>("unused"s)});
+        runtime::Class cls("WithArgument"s, std::move(methods), nullptr);
+        ASSERT(cls.GetStrMethod() == nullptr);
+    }
 
     ASSERT(context.output.str().empty());
 }
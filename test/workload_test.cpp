@@ -0,0 +1,59 @@
+#include "lexer.h"
+#include "parse.h"
+#include "runtime.h"
+#include "test_runner.h"
+#include "workload.h"
+
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+string RunProgram(const string &program) {
+    istringstream input(program);
+    parse::Lexer lexer(input);
+    auto tree = ParseProgram(lexer);
+
+    ostringstream output;
+    runtime::SimpleContext context{output};
+    runtime::Closure closure;
+    tree->Execute(closure, context);
+    return output.str();
+}
+
+void TestWorkload(const workload::Parameters &parameters) {
+    const auto generated = workload::Generate(parameters);
+    ASSERT_EQUAL(RunProgram(generated.program), generated.expected_output);
+}
+
+void TestDefaultWorkload() {
+    TestWorkload({});
+}
+
+void TestScaledWorkload() {
+    TestWorkload(workload::Parameters{}.Scale(10));
+}
+
+// Части нулевого размера пропускаются, цепочка полей и рекурсия вырождаются
+void TestEmptyWorkload() {
+    const auto generated = workload::Generate({0, 0, 0, 0, 0, 0});
+    ASSERT_EQUAL(generated.expected_output, "fields 0\nrecursion 0 0\n"s);
+    ASSERT_EQUAL(RunProgram(generated.program), generated.expected_output);
+}
+
+void TestScaleLimitsRecursion() {
+    const auto scaled = workload::Parameters{}.Scale(1000);
+    ASSERT_EQUAL(scaled.classes, 20000u);
+    ASSERT_EQUAL(scaled.tail_recursion_depth, 500000u);
+    ASSERT_EQUAL(scaled.recursion_depth, workload::Parameters::MAX_SCALED_RECURSION_DEPTH);
+}
+
+} // namespace
+
+void RunWorkloadTests(TestRunner &tr) {
+    RUN_TEST(tr, TestDefaultWorkload);
+    RUN_TEST(tr, TestScaledWorkload);
+    RUN_TEST(tr, TestEmptyWorkload);
+    RUN_TEST(tr, TestScaleLimitsRecursion);
+}